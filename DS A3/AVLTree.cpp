@@ -22,7 +22,7 @@ This file contains the implementation for the AVLTree
  *******************************************************************************/
 template <typename T>
 AVLTree<T>::AVLTree(ObjectAllocator *_OA, bool _shareOA)
-    : BSTree<T>{_OA, _shareOA}
+    : BSTree<T>{_OA, _shareOA}, m_Rotations{0}
 {
 }
 
@@ -58,6 +58,20 @@ void AVLTree<T>::remove(const T &_value)
     RemoveAVL(BSTree<T>::get_root(), _value, visitedNodes);
 }
 
+/*!*****************************************************************************
+ * @brief Returns the number of rotations done by this tree.
+ * 
+ * A double rotation counts as two. Together with the number of inserts and
+ * removes, this shows how much restructuring a workload causes.
+ * 
+ * @return The number of rotations since the tree was constructed.
+ *******************************************************************************/
+template <typename T>
+unsigned long long AVLTree<T>::rotations() const
+{
+    return m_Rotations;
+}
+
 /*!*****************************************************************************
  * @brief Indicates whether the balance factor is implemented in the AVL tree.
  * 
@@ -98,14 +112,12 @@ void AVLTree<T>::InsertAVL(BinTree &_tree, const T &_value, Stack &_visited)
     else if (_value < _tree->data)
     {
         _visited.push(&_tree);                    // Push the current node's address onto the stack before going left
-        ++_tree->count;                           // Increment the count of nodes in the subtree rooted at _tree
         InsertAVL(_tree->left, _value, _visited); // Recursive call to insert into the left subtree
     }
     // If the value is greater than the current node's data, explore the right subtree
     else if (_value > _tree->data)
     {
         _visited.push(&_tree);                     // Push the current node's address onto the stack before going right
-        ++_tree->count;                            // Increment the count of nodes in the subtree rooted at _tree
         InsertAVL(_tree->right, _value, _visited); // Recursive call to insert into the right subtree
     }
 }
@@ -116,7 +128,8 @@ void AVLTree<T>::InsertAVL(BinTree &_tree, const T &_value, Stack &_visited)
  * This function searches for and removes a node containing the specified value
  * from the AVL tree. It maintains the AVL tree properties by rebalancing the tree
  * after removal. A stack is used to keep track of visited nodes for potential
- * backtracking during the balancing phase.
+ * backtracking during the balancing phase. The balancing runs once, after the
+ * node has been unlinked, so every slot on the stack is still valid.
  * 
  * @param _tree Reference to the current subtree's root from which the value might be removed.
  * @param _value The value to be removed from the AVL tree.
@@ -133,20 +146,16 @@ void AVLTree<T>::RemoveAVL(BinTree &_tree, const T &_value, Stack &_visited)
     {
         _visited.push(&_tree); // Push the current node's address onto the stack before going left
         RemoveAVL(_tree->left, _value, _visited); // Recursive call to remove from the left subtree
-        --_tree->count; // Decrement the count after recursion
     }
     // If the value to be removed is greater than the current node's data, explore the right subtree
     else if (_value > _tree->data)
     {
         _visited.push(&_tree); // Push the current node's address onto the stack before going right
         RemoveAVL(_tree->right, _value, _visited); // Recursive call to remove from the right subtree
-        --_tree->count; // Decrement the count after recursion
     }
     // If the current node contains the value to be removed
     else
     {
-        --_tree->count; // Decrement the count for the current node
-
         // If the node to be removed has no left child
         if (_tree->left == nullptr)
         {
@@ -154,6 +163,7 @@ void AVLTree<T>::RemoveAVL(BinTree &_tree, const T &_value, Stack &_visited)
             _tree = _tree->right; // Replace the current node with its right child
             this->free_node(temp); // Free the memory of the deleted node
             --this->m_Size; // Decrement the size of the AVL tree
+            BalanceAVL(_visited); // Rebalance the tree after removal
         }
         // If the node to be removed has no right child
         else if (_tree->right == nullptr)
@@ -162,6 +172,7 @@ void AVLTree<T>::RemoveAVL(BinTree &_tree, const T &_value, Stack &_visited)
             _tree = _tree->left; // Replace the current node with its left child
             this->free_node(temp); // Free the memory of the deleted node
             --this->m_Size; // Decrement the size of the AVL tree
+            BalanceAVL(_visited); // Rebalance the tree after removal
         }
         // If the node to be removed has two children
         else
@@ -169,10 +180,9 @@ void AVLTree<T>::RemoveAVL(BinTree &_tree, const T &_value, Stack &_visited)
             BinTree pred = nullptr; // Pointer to hold the predecessor node
             this->find_predecessor(_tree, pred); // Find the predecessor of the current node
             _tree->data = pred->data; // Copy the data from the predecessor to the current node
+            _visited.push(&_tree); // The current node is on the path to the predecessor
             RemoveAVL(_tree->left, pred->data, _visited); // Recursively delete the predecessor node
         }
-
-        BalanceAVL(_visited); // Rebalance the tree after removal
     }
 }
 
@@ -181,8 +191,10 @@ void AVLTree<T>::RemoveAVL(BinTree &_tree, const T &_value, Stack &_visited)
  * 
  * This function iteratively examines each node in the path that was visited during
  * the insertion or removal operation (stored in a stack) and performs necessary rotations
- * to maintain the AVL tree balance. It checks the balance factor (difference in heights
- * between left and right subtrees) and applies single or double rotations as needed.
+ * to maintain the AVL tree balance. Each node first has its cached count and height
+ * refreshed from its children, then the balance factor (difference in heights
+ * between left and right subtrees) is checked and single or double rotations are
+ * applied as needed. Since heights are cached, each step is O(1).
  * 
  * @param _visited Stack of pointers to nodes that were visited during the insert or remove operation.
  *******************************************************************************/
@@ -194,6 +206,8 @@ void AVLTree<T>::BalanceAVL(Stack &_visited)
         BinTree *currentNode = _visited.top(); // Get the top node from the stack
         _visited.pop(); // Remove the top node from the stack
 
+        this->update_node(*currentNode); // Refresh the cached count and height of the current node
+
         int heightLeft = this->tree_height((*currentNode)->left); // Calculate the height of the left subtree
         int heightRight = this->tree_height((*currentNode)->right); // Calculate the height of the right subtree
 
@@ -221,8 +235,6 @@ void AVLTree<T>::BalanceAVL(Stack &_visited)
             }
             RightRotation(*currentNode); // Right rotation on the current node
         }
-
-        RecountAVL(*currentNode); // Recalculate the node counts after rotations
     }
 }
 
@@ -231,7 +243,8 @@ void AVLTree<T>::BalanceAVL(Stack &_visited)
  * 
  * This function performs a left rotation around the root of the specified subtree
  * to restore the AVL tree balance. It adjusts the pointers accordingly to rotate
- * the subtree and maintains the binary search tree properties.
+ * the subtree and maintains the binary search tree properties. The cached count
+ * and height of the two nodes that moved are refreshed.
  * 
  * @param _tree Reference to the root of the subtree to be rotated.
  *******************************************************************************/
@@ -241,7 +254,10 @@ void AVLTree<T>::LeftRotation(BinTree &_tree)
     BinTree newRoot = _tree->right; // The right child becomes the new root of the rotated subtree
     _tree->right = newRoot->left; // The left child of the new root becomes the right child of the old root
     newRoot->left = _tree; // The old root becomes the left child of the new root
+    this->update_node(_tree); // The old root is now below the new root, so refresh it first
+    this->update_node(newRoot); // Then refresh the new root
     _tree = newRoot; // Update the reference to point to the new root of the subtree
+    ++m_Rotations; // Count it for rotations()
 }
 
 /*!*****************************************************************************
@@ -249,7 +265,8 @@ void AVLTree<T>::LeftRotation(BinTree &_tree)
  * 
  * This function performs a right rotation around the root of the specified subtree
  * to restore the AVL tree balance. It adjusts the pointers accordingly to rotate
- * the subtree and maintains the binary search tree properties.
+ * the subtree and maintains the binary search tree properties. The cached count
+ * and height of the two nodes that moved are refreshed.
  * 
  * @param _tree Reference to the root of the subtree to be rotated.
  *******************************************************************************/
@@ -259,47 +276,8 @@ void AVLTree<T>::RightRotation(BinTree &_tree)
     BinTree newRoot = _tree->left; // The left child becomes the new root of the rotated subtree
     _tree->left = newRoot->right; // The right child of the new root becomes the left child of the old root
     newRoot->right = _tree; // The old root becomes the right child of the new root
+    this->update_node(_tree); // The old root is now below the new root, so refresh it first
+    this->update_node(newRoot); // Then refresh the new root
     _tree = newRoot; // Update the reference to point to the new root of the subtree
-}
-
-/*!*****************************************************************************
- * @brief Counts the number of nodes in a subtree.
- * 
- * This function recursively calculates the total number of nodes in the subtree
- * rooted at the given node, including the root node itself. It's a utility function
- * often used to update node counts in AVL tree operations.
- * 
- * @param _tree Reference to the root of the subtree to be counted.
- * @return The total number of nodes in the subtree.
- *******************************************************************************/
-template <typename T>
-unsigned int AVLTree<T>::CountTree(BinTree &_tree)
-{
-    if (_tree == nullptr) // Base case: if the subtree is empty, count is 0
-        return 0;
-
-    // Count the current node plus the counts from the left and right subtrees
-    return 1 + CountTree(_tree->left) + CountTree(_tree->right);
-}
-
-/*!*****************************************************************************
- * @brief Recalculates the 'count' field for each node in a subtree.
- * 
- * This function traverses the subtree rooted at the given node and updates the
- * 'count' field of each node to reflect the current number of nodes in its subtree.
- * It's used to ensure the 'count' field is accurate after modifications to the tree structure.
- * 
- * @param _tree Reference to the root of the subtree whose node counts are to be updated.
- *******************************************************************************/
-template <typename T>
-void AVLTree<T>::RecountAVL(BinTree &_tree)
-{
-    if (_tree == nullptr) // Base case: if the subtree is empty, there's nothing to recount
-        return;
-
-    _tree->count = CountTree(_tree); // Update the count of the current node
-
-    // Recursively update the counts for the left and right subtrees
-    RecountAVL(_tree->left);
-    RecountAVL(_tree->right);
+    ++m_Rotations; // Count it for rotations()
 }
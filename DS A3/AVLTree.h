@@ -26,6 +26,7 @@ class AVLTree : public BSTree<T>
     virtual ~AVLTree() = default; // DO NOT IMPLEMENT
     virtual void insert(const T& value) override;
     virtual void remove(const T& value) override;
+    unsigned long long rotations() const;
 
       // Returns true if efficiency implemented
     static bool ImplementedBalanceFactor(void);
@@ -40,8 +41,8 @@ class AVLTree : public BSTree<T>
     
     void LeftRotation(BinTree& tree);
     void RightRotation(BinTree& tree);
-    unsigned int CountTree(BinTree& tree);
-    void RecountAVL(BinTree& tree);
+
+    unsigned long long m_Rotations; //!< Rotations done since construction
 };
 
 #include "AVLTree.cpp"
@@ -49,4 +50,3 @@ class AVLTree : public BSTree<T>
 #endif
 //---------------------------------------------------------------------------
 
-s
\ No newline at end of file
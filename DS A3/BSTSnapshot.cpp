@@ -0,0 +1,164 @@
+/*!*************************************************************************
+\file BSTSnapshot.cpp
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the implementation for the BSTSnapshot
+***************************************************************************/
+#include "BSTSnapshot.h"
+
+/*!*****************************************************************************
+ * @brief Constructs an empty snapshot.
+ *******************************************************************************/
+template <typename T>
+BSTSnapshot<T>::BSTSnapshot()
+    : m_Keys{}, m_Size{0}
+{
+}
+
+/*!*****************************************************************************
+ * @brief Constructs a snapshot from a sorted sequence of keys.
+ *
+ * The keys are written into the array by an in-order walk of the implicit
+ * tree, which places every key at its Eytzinger position in O(n). The keys must
+ * be sorted in ascending order and contain no duplicates.
+ *
+ * @param _sorted The keys of the snapshot in ascending order.
+ *******************************************************************************/
+template <typename T>
+BSTSnapshot<T>::BSTSnapshot(const std::vector<T> &_sorted)
+    : m_Keys(_sorted.size() + 1), m_Size{static_cast<unsigned int>(_sorted.size())}
+{
+  size_t next = 0; // Next sorted key to place
+  FillEytzinger(_sorted, next, 1);
+}
+
+/*!*****************************************************************************
+ * @brief Searches for a value in the snapshot, tracking the number of comparisons.
+ *
+ * The search always walks down to the bottom of the implicit tree. Each step
+ * picks the child with a single less-than comparison and no branch on the
+ * result, and the cache line holding the keys a few levels below is prefetched
+ * while the current level is compared. The match, if any, is recovered from the
+ * final position at the end.
+ *
+ * The compares are counted the same way as BSTree::find counts them: one per
+ * node on the path to the match, or one per node on the path plus one for the
+ * empty subtree when the value is missing. The implicit tree has the same shape
+ * as a BSTree built by build_from_sorted, so both report identical counts.
+ *
+ * @param _value The value to search for in the snapshot.
+ * @param _compares A reference to an unsigned variable where the function will
+ *                  add the number of comparisons made during the search.
+ * @return True if the value is found in the snapshot, false otherwise.
+ *******************************************************************************/
+template <typename T>
+bool BSTSnapshot<T>::find(const T &_value, unsigned &_compares) const
+{
+  const T *keys = m_Keys.data();
+  size_t index = 1; // Start at the root of the implicit tree
+
+  while (index <= m_Size)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    // The 16 descendants four levels down share one or a few cache lines
+    size_t ahead = index * 16;
+    if (ahead <= m_Size)
+      __builtin_prefetch(keys + ahead);
+#endif
+    index = 2 * index + static_cast<size_t>(keys[index] < _value); // Go right if the key is smaller
+  }
+
+  // The last step to the left was taken at the candidate; undo every step to the right after it
+  unsigned pathLength = BitWidth(index) - 1; // Nodes visited on the way down
+  index >>= BitWidth(~index & (index + 1)); // Strip the trailing ones and the last left step
+
+  if (index != 0 && !(_value < keys[index]))
+  {
+    _compares += BitWidth(index); // The depth of the match plus one
+    return true;
+  }
+
+  _compares += pathLength + 1; // Every node on the path plus the empty subtree
+  return false;
+}
+
+/*!*****************************************************************************
+ * @brief Checks if the snapshot is empty.
+ *
+ * @return True if the snapshot holds no keys, false otherwise.
+ *******************************************************************************/
+template <typename T>
+bool BSTSnapshot<T>::empty() const
+{
+  return m_Size == 0;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of keys in the snapshot.
+ *
+ * @return The number of keys in the snapshot.
+ *******************************************************************************/
+template <typename T>
+unsigned int BSTSnapshot<T>::size() const
+{
+  return m_Size;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the height of the implicit tree.
+ *
+ * The implicit tree is complete, so its height only depends on the number of
+ * keys. An empty snapshot has a height of -1, like an empty BSTree.
+ *
+ * @return The height of the implicit tree.
+ *******************************************************************************/
+template <typename T>
+int BSTSnapshot<T>::height() const
+{
+  return static_cast<int>(BitWidth(m_Size)) - 1;
+}
+
+/*!*****************************************************************************
+ * @brief Recursively places sorted keys at their Eytzinger positions.
+ *
+ * @param _sorted The keys in ascending order.
+ * @param _next Index of the next sorted key to place.
+ * @param _index Position of the current node in the implicit tree.
+ *******************************************************************************/
+template <typename T>
+void BSTSnapshot<T>::FillEytzinger(const std::vector<T> &_sorted, size_t &_next, size_t _index)
+{
+  if (_index > m_Size) // Base case: past the bottom of the implicit tree
+    return;
+
+  FillEytzinger(_sorted, _next, 2 * _index);     // Smaller keys on the left
+  m_Keys[_index] = _sorted[_next++];             // Then the current node
+  FillEytzinger(_sorted, _next, 2 * _index + 1); // Then the larger keys
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of bits needed to represent a value.
+ *
+ * @param _value The value to measure.
+ * @return The position of the highest set bit plus one, or 0 for 0.
+ *******************************************************************************/
+template <typename T>
+unsigned BSTSnapshot<T>::BitWidth(size_t _value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  // Count the leading zeros in a single instruction
+  return _value ? static_cast<unsigned>(sizeof(unsigned long long) * 8 - __builtin_clzll(_value)) : 0;
+#else
+  unsigned width = 0;
+  while (_value)
+  {
+    ++width;
+    _value >>= 1;
+  }
+  return width;
+#endif
+}
@@ -0,0 +1,46 @@
+/*!*************************************************************************
+\file BSTSnapshot.h
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the declaration for the BSTSnapshot, a read-only copy
+of a BSTree stored as one array in Eytzinger (breadth-first) order
+***************************************************************************/
+//---------------------------------------------------------------------------
+#ifndef BSTSNAPSHOT_H
+#define BSTSNAPSHOT_H
+//---------------------------------------------------------------------------
+#include <vector>  // std::vector
+#include <cstddef> // size_t
+
+/*!
+  Immutable search tree laid out in one array. The children of the key at
+  index k live at 2k and 2k + 1 (index 0 is unused), so a lookup walks down a
+  contiguous block of memory instead of chasing pointers.
+*/
+template <typename T>
+class BSTSnapshot
+{
+  public:
+    BSTSnapshot();
+    BSTSnapshot(const std::vector<T>& sorted);
+    bool find(const T& value, unsigned &compares) const;
+    bool empty() const;
+    unsigned int size() const;
+    int height() const;
+
+  private:
+    void FillEytzinger(const std::vector<T>& _sorted, size_t& _next, size_t _index);
+    static unsigned BitWidth(size_t _value);
+
+    std::vector<T> m_Keys; //!< Keys in Eytzinger order, starting at index 1
+    unsigned int m_Size;   //!< Number of keys in the snapshot
+};
+
+#include "BSTSnapshot.cpp"
+
+#endif
+//---------------------------------------------------------------------------
@@ -14,15 +14,17 @@ This file contains the implementation for the BSTree
  * @brief Constructs a binary search tree with optional custom memory allocation.
  * 
  * Initializes a binary search tree, optionally using an external memory allocator.
- * If no allocator is provided, it creates a default one. The constructor also sets
- * the sharing policy for the allocator.
+ * If no allocator is provided and the allocator is not meant to be shared, the
+ * tree takes its nodes from a private NodeArena, which lets clear() and the
+ * destructor give back all nodes at once. If it is meant to be shared, a default
+ * ObjectAllocator is created that copies of the tree can use too.
  * 
  * @param _allocator A pointer to an ObjectAllocator to be used for node allocations.
  * @param _shareAllocator Boolean indicating whether the allocator should be shared.
  *******************************************************************************/
 template <typename T>
 BSTree<T>::BSTree(ObjectAllocator *_allocator, bool _shareAllocator)
-    : m_RootNode{nullptr}, m_Size{0}, m_Height{-1}, m_ShareOA{_shareAllocator}
+    : m_RootNode{nullptr}, m_Size{0}, m_ShareOA{_shareAllocator}
 {
   // If an external allocator is provided, use it and set not to free on destruction.
   if (_allocator)
@@ -30,13 +32,19 @@ BSTree<T>::BSTree(ObjectAllocator *_allocator, bool _shareAllocator)
     m_OA = _allocator; // Use provided allocator
     m_FreeOA = false; // Do not free OA as it's provided externally
   }
-  else
+  else if (_shareAllocator)
   {
-    // No external allocator provided; create a default one.
+    // No external allocator provided, but copies will share it; create a default one.
     OAConfig defaultConfig(true); // Create a default configuration for the allocator
     m_OA = new ObjectAllocator(sizeof(BinTreeNode), defaultConfig); // Allocate a new ObjectAllocator with the default configuration
     m_FreeOA = true; // Set to free m_OA on destruction since it was created here
   }
+  else
+  {
+    // Nobody else will use the allocator, so the private arena is used instead
+    m_OA = nullptr;
+    m_FreeOA = false;
+  }
   m_ShareOA = _shareAllocator; // Set the sharing policy for the allocator
 }
 
@@ -44,14 +52,15 @@ BSTree<T>::BSTree(ObjectAllocator *_allocator, bool _shareAllocator)
  * @brief Constructs a new BSTree as a copy of an existing tree.
  * 
  * This constructor creates a deep copy of an existing BSTree. It either shares
- * the ObjectAllocator with the source tree or creates a new one, depending on
- * the sharing policy of the source tree.
+ * the ObjectAllocator with the source tree or takes its nodes from its own
+ * private arena, depending on the sharing policy of the source tree. With the
+ * arena, all nodes of the copy are requested from the heap at once.
  * 
  * @param _rhs The source tree to copy from.
  *******************************************************************************/
 template <typename T>
 BSTree<T>::BSTree(const BSTree<T> &_rhs)
-    : m_Size{_rhs.m_Size}, m_Height{_rhs.m_Height}, m_ShareOA{_rhs.m_ShareOA}
+    : m_Size{_rhs.m_Size}, m_ShareOA{_rhs.m_ShareOA}
 {
   // If the source tree is sharing its ObjectAllocator, share it and avoid freeing it.
   if (_rhs.m_ShareOA)
@@ -61,13 +70,14 @@ BSTree<T>::BSTree(const BSTree<T> &_rhs)
   }
   else
   {
-    // If the source tree is not sharing its ObjectAllocator, create a new one.
-    OAConfig defaultConfig(true); // Default configuration for the new allocator
-    m_OA = new ObjectAllocator(sizeof(BinTreeNode), defaultConfig); // Allocate a new ObjectAllocator
-    m_FreeOA = true; // Set to free m_OA on destruction since it was created here
+    // If the source tree is not sharing its ObjectAllocator, use the private arena.
+    m_OA = nullptr;
+    m_FreeOA = false;
   }
 
   // Perform a deep copy of the tree nodes from _rhs to this tree.
+  if (m_OA == nullptr)
+    m_Arena.reserve(_rhs.m_Size); // One block for the whole copy
   DeepCopyTree(_rhs.m_RootNode, m_RootNode);
 }
 
@@ -107,32 +117,30 @@ BSTree<T> &BSTree<T>::operator=(const BSTree<T> &_rhs)
   if (this == &_rhs)
     return *this;
 
+  // The current nodes go back to the allocator they came from
+  clear();
+
   // If the source tree shares its ObjectAllocator, manage the current allocator accordingly
   if (_rhs.m_ShareOA)
   {
-    // If the current tree owns its ObjectAllocator, clear the tree and delete the allocator
+    // If the current tree owns its ObjectAllocator, delete the allocator
     if (m_FreeOA)
-    {
-      clear(); // Clear all nodes in the current tree
       delete m_OA; // Delete the current ObjectAllocator
-    }
 
     // Use the ObjectAllocator from the rhs tree and update sharing and ownership flags
     m_OA = _rhs.m_OA;
     m_FreeOA = false; // Current tree should not delete the shared allocator
     m_ShareOA = true; // Current tree is now sharing the allocator
   }
-  else
+  else if (m_OA == nullptr)
   {
-    // If the current tree is not sharing its allocator, just clear the tree
-    // A new allocator will be created if needed in DeepCopyTree
-    clear();
+    // The arena was just reset, so the whole copy can come from one block
+    m_Arena.reserve(_rhs.m_Size);
   }
 
   // Deep copy the tree structure from rhs to this tree
   DeepCopyTree(_rhs.m_RootNode, m_RootNode);
   m_Size = _rhs.m_Size; // Copy the size
-  m_Height = _rhs.m_Height; // Copy the height
 
   return *this; // Return a reference to the current tree
 }
@@ -173,7 +181,7 @@ void BSTree<T>::insert(const T &_value)
   try
   {
     // Attempt to insert the new value into the tree
-    InsertNode(m_RootNode, _value, 0);
+    InsertNode(m_RootNode, _value);
   }
   catch (const BSTException &except)
   {
@@ -186,8 +194,8 @@ void BSTree<T>::insert(const T &_value)
  * @brief Removes a value from the BSTree, if it exists.
  * 
  * This function searches for a node containing the specified value and removes
- * it from the tree, maintaining the binary search tree properties. After removal,
- * it recalculates the height of the tree to ensure accurate tree metrics.
+ * it from the tree, maintaining the binary search tree properties. The cached
+ * subtree heights and counts are refreshed along the search path only.
  * 
  * @param value The value to be removed from the tree.
  *******************************************************************************/
@@ -196,9 +204,6 @@ void BSTree<T>::remove(const T &_value)
 {
   // Remove the node with the specified value from the tree
   DeleteNode(m_RootNode, const_cast<T &>(_value)); // Using const_cast to modify a const value is generally not recommended; consider revising the design if possible.
-
-  // Recalculate the height of the tree after the removal
-  m_Height = tree_height(m_RootNode);
 }
 
 /*!*****************************************************************************
@@ -206,11 +211,34 @@ void BSTree<T>::remove(const T &_value)
  * 
  * This function removes all nodes from the tree, effectively resetting it to its
  * initial state. After clearing, the tree will be empty, with a size of 0 and a
- * height of -1, indicating that it contains no nodes.
+ * height of -1, indicating that it contains no nodes. When the nodes come from
+ * the private arena, the arena is reset in one step instead of freeing every
+ * node, and for values without a destructor the nodes are not visited at all.
  *******************************************************************************/
 template <typename T>
 void BSTree<T>::clear()
 {
+  rebuilding();
+  ClearTree();
+  rebuilt();
+}
+
+/*!*****************************************************************************
+ * @brief Frees every node and leaves the tree empty, without calling the hooks.
+ *******************************************************************************/
+template <typename T>
+void BSTree<T>::ClearTree()
+{
+  if (m_OA == nullptr) // Nodes come from the private arena
+  {
+    if (!std::is_trivially_destructible<T>::value)
+      DestroyTree(m_RootNode); // The values still need their destructors
+    m_Arena.reset(); // Give back every node at once
+    m_RootNode = nullptr;
+    m_Size = 0;
+    return;
+  }
+
   // Check if the tree has any nodes to clear
   if (m_RootNode)
   {
@@ -219,10 +247,143 @@ void BSTree<T>::clear()
     // Reset tree properties to represent an empty tree
     m_RootNode = nullptr; // Set the root node pointer to nullptr
     m_Size = 0;           // Reset the size of the tree to 0
-    m_Height = -1;        // Reset the height of the tree to -1, indicating an empty tree
   }
 }
 
+/*!*****************************************************************************
+ * @brief Replaces the contents of the BSTree with a range of sorted values.
+ * 
+ * This function clears the tree and builds a perfectly balanced tree from the
+ * given range in O(n), without any comparisons or rotations. The values must be
+ * sorted in ascending order and contain no duplicates. Every node is allocated
+ * through the tree's ObjectAllocator, and the count, height and balance factor
+ * of each node are set as the tree is linked. Since the result is perfectly
+ * balanced, it is also a valid AVL tree. rebuilding is called before the old
+ * nodes are freed and rebuilt once the new tree is in place.
+ * 
+ * @param _first Iterator to the first value of the sorted range.
+ * @param _last Iterator one past the last value of the sorted range.
+ *******************************************************************************/
+template <typename T>
+template <typename Iter>
+void BSTree<T>::build_from_sorted(Iter _first, Iter _last)
+{
+  rebuilding();
+  ClearTree(); // Start from an empty tree
+
+  std::vector<BinTree> nodes; // Allocated nodes in ascending order
+  try
+  {
+    // Allocate one node per value, in order
+    for (; _first != _last; ++_first)
+      nodes.push_back(make_node(*_first));
+  }
+  catch (...)
+  {
+    // Give back whatever was allocated before the failure and leave the tree empty
+    for (size_t i = 0; i < nodes.size(); ++i)
+      free_node(nodes[i]);
+    rebuilt();
+    throw; // For rethrowing the current exception without losing its original context
+  }
+
+  // Link the nodes into a balanced shape
+  m_RootNode = LinkBalanced(nodes, 0, nodes.size());
+  m_Size = static_cast<unsigned int>(nodes.size());
+  rebuilt();
+}
+
+/*!*****************************************************************************
+ * @brief Inserts a batch of unsorted values into the BSTree in one pass.
+ * 
+ * This function sorts the batch, merges it with the in-order sequence of the
+ * existing nodes and relinks everything into a perfectly balanced tree. Existing
+ * nodes are reused, so only the new values are allocated, and values that are
+ * already in the tree (or repeated in the batch) are skipped. The total cost is
+ * O(n + k log k) for n existing nodes and k new values, instead of k separate
+ * insertions that may degrade the shape of the tree. rebuilding is called
+ * before the existing nodes are read and rebuilt once they are relinked.
+ * 
+ * @param _first Iterator to the first value of the batch.
+ * @param _last Iterator one past the last value of the batch.
+ *******************************************************************************/
+template <typename T>
+template <typename Iter>
+void BSTree<T>::bulk_insert(Iter _first, Iter _last)
+{
+  // Sort the batch and drop repeated values
+  std::vector<T> batch(_first, _last);
+  std::sort(batch.begin(), batch.end());
+  batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+
+  rebuilding();
+  std::vector<BinTree> existing; // Existing nodes in ascending order
+  std::vector<BinTree> merged;
+  std::vector<BinTree> created;  // Only the nodes allocated for this batch
+  try
+  {
+    existing.reserve(m_Size);
+    CollectNodes(m_RootNode, existing);
+
+    // Merge both sequences, allocating nodes only for values not yet in the tree
+    merged.reserve(existing.size() + batch.size());
+    size_t i = 0;
+    for (size_t j = 0; j < batch.size(); ++j)
+    {
+      // Take every existing node that comes before the new value
+      while (i < existing.size() && existing[i]->data < batch[j])
+        merged.push_back(existing[i++]);
+
+      // Skip values that are already in the tree
+      if (i < existing.size() && !(batch[j] < existing[i]->data))
+        continue;
+
+      created.push_back(make_node(batch[j]));
+      merged.push_back(created.back());
+    }
+
+    // Take the remaining existing nodes
+    while (i < existing.size())
+      merged.push_back(existing[i++]);
+  }
+  catch (...)
+  {
+    // Free only the new nodes; the existing tree has not been touched yet
+    for (size_t i = 0; i < created.size(); ++i)
+      free_node(created[i]);
+    rebuilt();
+    throw; // For rethrowing the current exception without losing its original context
+  }
+
+  // Relink the merged nodes into a balanced shape
+  m_RootNode = LinkBalanced(merged, 0, merged.size());
+  m_Size += static_cast<unsigned int>(created.size());
+  rebuilt();
+}
+
+/*!*****************************************************************************
+ * @brief Called before clear, build_from_sorted or bulk_insert touch the nodes.
+ * 
+ * Derived trees override it to prepare for the nodes being freed or relinked.
+ * The base version does nothing.
+ *******************************************************************************/
+template <typename T>
+void BSTree<T>::rebuilding()
+{
+}
+
+/*!*****************************************************************************
+ * @brief Called once clear, build_from_sorted or bulk_insert are done.
+ * 
+ * The tree is then perfectly balanced (or empty), also when the call failed.
+ * Derived trees override it to restore what they keep in the nodes, such as
+ * colors or priorities. The base version does nothing.
+ *******************************************************************************/
+template <typename T>
+void BSTree<T>::rebuilt()
+{
+}
+
 /*!*****************************************************************************
  * @brief Searches for a value in the BSTree, tracking the number of comparisons.
  * 
@@ -276,16 +437,17 @@ unsigned int BSTree<T>::size() const
 /*!*****************************************************************************
  * @brief Returns the height of the BSTree.
  * 
- * This function calculates the height of the binary search tree from the root
+ * This function returns the height of the binary search tree from the root
  * node. The height is defined as the number of edges on the longest path from
- * the root node to a leaf node.
+ * the root node to a leaf node. It is read from the root's cached height, so
+ * the call is O(1).
  * 
  * @return The height of the tree.
  *******************************************************************************/
 template <typename T>
 int BSTree<T>::height() const
 {
-  return tree_height(m_RootNode); // Calculate and return the height of the tree starting from the root node
+  return tree_height(m_RootNode); // Return the cached height of the tree starting from the root node
 }
 
 /*!*****************************************************************************
@@ -302,6 +464,160 @@ typename BSTree<T>::BinTree BSTree<T>::root() const
   return m_RootNode; // Return a const pointer to the root node
 }
 
+/*!*****************************************************************************
+ * @brief Creates a read-only, cache-friendly copy of the BSTree.
+ * 
+ * The keys are copied in order into a BSTSnapshot, which stores them as one
+ * array in Eytzinger order. The snapshot does not share anything with the tree,
+ * so the tree can keep changing while the snapshot is being searched. Lookups
+ * in the snapshot count compares the same way find does, one per node visited,
+ * and report exactly the same counts as a tree built by build_from_sorted.
+ * 
+ * @return A snapshot holding the current keys of the tree.
+ *******************************************************************************/
+template <typename T>
+BSTSnapshot<T> BSTree<T>::freeze() const
+{
+  std::vector<BinTree> nodes; // Nodes in ascending order
+  nodes.reserve(m_Size);
+  CollectNodes(m_RootNode, nodes);
+
+  std::vector<T> keys; // Keys in ascending order
+  keys.reserve(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+    keys.push_back(nodes[i]->data);
+
+  return BSTSnapshot<T>(keys);
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of values in the BSTree that are less than a value.
+ * 
+ * This function walks a single path from the root. Whenever it moves right,
+ * the current node and its whole left subtree are smaller than the value, and
+ * their number is read from the cached count, so the call is O(height). The
+ * value itself does not have to be in the tree. For a value in the tree, the
+ * rank is its index, so tree[tree.rank(value)] is the node holding it.
+ * 
+ * @param _value The value to rank.
+ * @return The number of values less than _value.
+ *******************************************************************************/
+template <typename T>
+unsigned int BSTree<T>::rank(const T &_value) const
+{
+  unsigned int smaller = 0; // Values known to be less than _value
+  BinTree node = m_RootNode;
+
+  while (node)
+  {
+    if (node->data < _value) // The node and its left subtree are all smaller
+    {
+      smaller += ((node->left) ? node->left->count : 0) + 1;
+      node = node->right;
+    }
+    else // Everything smaller is in the left subtree
+      node = node->left;
+  }
+
+  return smaller;
+}
+
+/*!*****************************************************************************
+ * @brief Finds the first node whose value is not less than a value.
+ * 
+ * @param _value The value to search for.
+ * @return The node holding the smallest value >= _value, or nullptr if there is none.
+ *******************************************************************************/
+template <typename T>
+const typename BSTree<T>::BinTreeNode *BSTree<T>::lower_bound(const T &_value) const
+{
+  BinTree result = nullptr; // Best candidate so far
+  BinTree node = m_RootNode;
+
+  while (node)
+  {
+    if (node->data < _value) // Too small, the answer is on the right
+      node = node->right;
+    else // A candidate, but there may be a smaller one on the left
+    {
+      result = node;
+      node = node->left;
+    }
+  }
+
+  return result;
+}
+
+/*!*****************************************************************************
+ * @brief Finds the first node whose value is greater than a value.
+ * 
+ * @param _value The value to search for.
+ * @return The node holding the smallest value > _value, or nullptr if there is none.
+ *******************************************************************************/
+template <typename T>
+const typename BSTree<T>::BinTreeNode *BSTree<T>::upper_bound(const T &_value) const
+{
+  BinTree result = nullptr; // Best candidate so far
+  BinTree node = m_RootNode;
+
+  while (node)
+  {
+    if (_value < node->data) // A candidate, but there may be a smaller one on the left
+    {
+      result = node;
+      node = node->left;
+    }
+    else // Too small or equal, the answer is on the right
+      node = node->right;
+  }
+
+  return result;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the values in the half-open range [low, high) in order.
+ * 
+ * The range is walked lazily with an explicit path, so only the nodes in the
+ * range and one path from the root are visited, and breaking out of the loop
+ * stops the walk. The number of values in the range is
+ * rank(high) - rank(low), which can be found without walking it.
+ * 
+ * @param _low The inclusive lower end of the range.
+ * @param _high The exclusive upper end of the range.
+ * @return An object with begin() and end() for a range-based for loop.
+ *******************************************************************************/
+template <typename T>
+typename BSTree<T>::Range BSTree<T>::range(const T &_low, const T &_high) const
+{
+  return Range(m_RootNode, &_low, &_high);
+}
+
+/*!*****************************************************************************
+ * @brief Returns the values that start with a prefix, in order.
+ * 
+ * This is meant for string trees. All values that start with the prefix form
+ * one contiguous range, from the prefix itself up to the prefix with its last
+ * character incremented. Like range, the values are produced lazily, so an
+ * autocomplete that only needs the first few matches stops early.
+ * 
+ * @param _prefix The prefix the values must start with.
+ * @return An object with begin() and end() for a range-based for loop.
+ *******************************************************************************/
+template <typename T>
+typename BSTree<T>::Range BSTree<T>::prefix_range(const T &_prefix) const
+{
+  // The first string after every string with this prefix
+  T high = _prefix;
+  while (!high.empty() && static_cast<unsigned char>(high[high.size() - 1]) == 0xFF)
+    high.erase(high.size() - 1); // Cannot be incremented, drop it
+  
+  if (high.empty()) // Nothing larger than the prefix, so the range is open-ended
+    return Range(m_RootNode, &_prefix, 0);
+
+  ++high[high.size() - 1];
+  return Range(m_RootNode, &_prefix, &high);
+}
+
 /*!*****************************************************************************
  * @brief Provides modifiable access to the root node of the BSTree.
  * 
@@ -331,8 +647,8 @@ typename BSTree<T>::BinTree BSTree<T>::make_node(const T &_value) const
 {
   try
   {
-    // Allocate memory for the node using the ObjectAllocator
-    BinTree allocatedMemory = reinterpret_cast<BinTree>(m_OA->Allocate());
+    // Allocate memory for the node using the ObjectAllocator, or the private arena
+    BinTree allocatedMemory = reinterpret_cast<BinTree>(m_OA ? m_OA->Allocate() : m_Arena.allocate());
 
     // Use placement new to construct the node in the allocated memory
     BinTree newNode = new (allocatedMemory) BinTreeNode(_value);
@@ -345,6 +661,11 @@ typename BSTree<T>::BinTree BSTree<T>::make_node(const T &_value) const
     // If memory allocation fails, throw a BSTException with a specific error code and message
     throw BSTException(BSTException::E_NO_MEMORY, except.what());
   }
+  catch (const std::bad_alloc &except)
+  {
+    // The arena could not get a new block from the heap
+    throw BSTException(BSTException::E_NO_MEMORY, except.what());
+  }
 }
 
 /*!*****************************************************************************
@@ -362,18 +683,22 @@ void BSTree<T>::free_node(BinTree _node)
   // Explicitly call the destructor for the node to clean up its resources
   _node->~BinTreeNode();
 
-  // Use the custom ObjectAllocator to deallocate the memory for the node
-  m_OA->Free(_node);
+  // Use the custom ObjectAllocator (or the private arena) to deallocate the memory for the node
+  if (m_OA)
+    m_OA->Free(_node);
+  else
+    m_Arena.free(_node);
 }
 
 /*!*****************************************************************************
- * @brief Calculates the height of the binary search tree.
+ * @brief Returns the height of the binary search tree.
  * 
- * This function determines the height of the tree or subtree rooted at the given
+ * This function returns the height of the tree or subtree rooted at the given
  * node. The height of a tree is the number of edges on the longest path from the
- * root node to a leaf node. An empty tree has a height of -1.
+ * root node to a leaf node. An empty tree has a height of -1. Every node caches
+ * the height of its own subtree, so no traversal is needed.
  * 
- * @param tree The root node of the tree or subtree whose height is to be calculated.
+ * @param tree The root node of the tree or subtree whose height is to be returned.
  * @return The height of the tree or subtree.
  *******************************************************************************/
 template <typename T>
@@ -383,14 +708,29 @@ int BSTree<T>::tree_height(BinTree _tree) const
   if (_tree == nullptr)
     return -1;
   else
-  {
-    // Recursively calculate the height of the left and right subtrees
-    int height_left = tree_height(_tree->left);
-    int height_right = tree_height(_tree->right);
+    return _tree->height; // Otherwise use the height cached in the node
+}
 
-    // The height of the current node is 1 plus the greater of the heights of its subtrees
-    return std::max(height_left, height_right) + 1;
-  }
+/*!*****************************************************************************
+ * @brief Refreshes the cached height and count of a node from its children.
+ * 
+ * This function must be called on every node whose children changed, working
+ * from the bottom of the tree upwards, so that the cached values stay correct.
+ * Both values are derived from the children only, which makes the update O(1).
+ * 
+ * @param _node The node whose cached metrics are to be refreshed.
+ *******************************************************************************/
+template <typename T>
+void BSTree<T>::update_node(BinTree _node) const
+{
+  unsigned int left_count = (_node->left) ? _node->left->count : 0;   // Count of nodes in the left subtree
+  unsigned int right_count = (_node->right) ? _node->right->count : 0; // Count of nodes in the right subtree
+
+  // The node itself plus everything below it
+  _node->count = left_count + right_count + 1;
+
+  // The height of the node is 1 plus the greater of the heights of its subtrees
+  _node->height = std::max(tree_height(_node->left), tree_height(_node->right)) + 1;
 }
 
 /*!*****************************************************************************
@@ -437,6 +777,7 @@ void BSTree<T>::DeepCopyTree(const BinTree &_source, BinTree &_dest)
     _dest = make_node(_source->data); // Create a new node with the same data as the source node
     _dest->count = _source->count; // Copy the count from the source to the destination node
     _dest->balance_factor = _source->balance_factor; // Copy the balance factor
+    _dest->height = _source->height; // Copy the cached subtree height
 
     // Recursively copy the left and right subtrees
     DeepCopyTree(_source->left, _dest->left);
@@ -466,19 +807,37 @@ void BSTree<T>::FreeTree(BinTree _tree)
   free_node(_tree);
 }
 
+/*!*****************************************************************************
+ * @brief Recursively destroys all nodes in a tree or subtree without freeing them.
+ * 
+ * This is used before the private arena is reset, which gives back the memory
+ * of all nodes at once.
+ * 
+ * @param _tree The root node of the tree or subtree to be destroyed.
+ *******************************************************************************/
+template <typename T>
+void BSTree<T>::DestroyTree(BinTree _tree)
+{
+  if (_tree == nullptr) // Base case: nothing to destroy
+    return;
+
+  DestroyTree(_tree->left);
+  DestroyTree(_tree->right);
+  _tree->~BinTreeNode(); // The memory itself stays with the arena
+}
+
 /*!*****************************************************************************
  * @brief Recursively inserts a new value into the BSTree, updating tree metrics.
  * 
  * This function inserts a new value into the binary search tree at the correct
- * position to maintain BST properties. It also updates the size and height of the
- * tree as necessary, and increments the count of nodes in the path to the inserted node.
+ * position to maintain BST properties. It also updates the size of the tree, and
+ * refreshes the cached count and height of the nodes in the path to the inserted node.
  * 
  * @param _node Reference to the node pointer where the new value might be inserted.
  * @param _value The value to insert into the tree.
- * @param _depth The current depth in the tree, used for height calculation.
  *******************************************************************************/
 template <typename T>
-void BSTree<T>::InsertNode(BinTree &_node, const T &_value, int _depth)
+void BSTree<T>::InsertNode(BinTree &_node, const T &_value)
 {
   try
   {
@@ -487,26 +846,21 @@ void BSTree<T>::InsertNode(BinTree &_node, const T &_value, int _depth)
     {
       _node = make_node(_value); // Create a new node with the given value
       ++m_Size; // Increment the size of the tree
-
-      // Update the tree's height if the current depth is greater
-      if (_depth > m_Height)
-        m_Height = _depth;
-
       return;
     }
 
     // If the value is less than the current node's data, insert into the left subtree
     if (_value < _node->data)
     {
-      InsertNode(_node->left, _value, _depth + 1); // Recursive call for the left child
+      InsertNode(_node->left, _value); // Recursive call for the left child
     }
     else // Otherwise, insert into the right subtree
     {
-      InsertNode(_node->right, _value, _depth + 1); // Recursive call for the right child
+      InsertNode(_node->right, _value); // Recursive call for the right child
     }
 
-    // After insertion, increment the count for the current node
-    ++_node->count;
+    // After insertion, refresh the count and height for the current node
+    update_node(_node);
   }
   catch (const BSTException &except)
   {
@@ -521,7 +875,7 @@ void BSTree<T>::InsertNode(BinTree &_node, const T &_value, int _depth)
  * This function searches for and deletes a node containing the given value.
  * If the node to be deleted has two children, it finds the predecessor, copies
  * its data to the node, and then recursively deletes the predecessor. It also
- * updates the node count and tree size as necessary.
+ * refreshes the cached count and height of the nodes on the path and the tree size.
  * 
  * @param _node Reference to the current node being examined or modified.
  * @param _value The value of the node to be deleted.
@@ -535,17 +889,15 @@ void BSTree<T>::DeleteNode(BinTree &_node, const T &_value)
   if (_value < _node->data) // If the value is in the left subtree
   {
     DeleteNode(_node->left, _value); // Recurse on the left child
-    --_node->count; // Decrement the count after recursion
+    update_node(_node); // Refresh the count and height after recursion
   }
   else if (_value > _node->data) // If the value is in the right subtree
   {
     DeleteNode(_node->right, _value); // Recurse on the right child
-    --_node->count; // Decrement the count after recursion
+    update_node(_node); // Refresh the count and height after recursion
   }
   else // If the current node contains the value to be deleted
   {
-    --_node->count; // Decrement the count
-
     // Case 1: The node has no left child (also covers the case where the node has no children)
     if (_node->left == nullptr)
     {
@@ -569,6 +921,7 @@ void BSTree<T>::DeleteNode(BinTree &_node, const T &_value)
       find_predecessor(_node, pred); // Find the predecessor of the current node
       _node->data = pred->data; // Copy the data from the predecessor to the current node
       DeleteNode(_node->left, pred->data); // Recursively delete the predecessor node
+      update_node(_node); // Refresh the count and height after recursion
     }
   }
 }
@@ -637,4 +990,71 @@ typename BSTree<T>::BinTree BSTree<T>::FindNodeAtIndex(BinTree _tree, unsigned _
   {
     return _tree;
   }
-}
\ No newline at end of file
+}
+
+/*!*****************************************************************************
+ * @brief Collects the nodes of a tree or subtree in ascending order.
+ * 
+ * This function performs an in-order traversal of the subtree rooted at the
+ * given node and appends every node to the given vector. The nodes themselves
+ * are not modified.
+ * 
+ * @param _tree The root of the tree or subtree to collect.
+ * @param _nodes The vector that receives the nodes in ascending order.
+ *******************************************************************************/
+template <typename T>
+void BSTree<T>::CollectNodes(BinTree _tree, std::vector<BinTree> &_nodes) const
+{
+  if (_tree == nullptr) // Base case: nothing to collect
+    return;
+
+  CollectNodes(_tree->left, _nodes);  // Smaller values first
+  _nodes.push_back(_tree);            // Then the current node
+  CollectNodes(_tree->right, _nodes); // Then the larger values
+}
+
+/*!*****************************************************************************
+ * @brief Links a sorted range of nodes into a perfectly balanced subtree.
+ * 
+ * The subtree is given the shape of a complete binary tree: every level is full
+ * except the last one, which is filled from the left. The root is picked so that
+ * the left part holds exactly the nodes of such a left subtree, and both parts
+ * are linked recursively. This is the same shape that BSTSnapshot stores, so
+ * both report the same compares. Each node's count, height and balance factor
+ * (right height minus left height) are set on the way back up, so the whole
+ * range is linked in O(n).
+ * 
+ * @param _nodes The nodes to link, sorted by their data.
+ * @param _first Index of the first node of the range.
+ * @param _last Index one past the last node of the range.
+ * @return The root of the linked subtree, or nullptr if the range is empty.
+ *******************************************************************************/
+template <typename T>
+typename BSTree<T>::BinTree BSTree<T>::LinkBalanced(std::vector<BinTree> &_nodes, size_t _first, size_t _last) const
+{
+  if (_first >= _last) // Base case: an empty range is an empty subtree
+    return nullptr;
+
+  size_t count = _last - _first; // Nodes in this subtree
+
+  // Nodes in a full tree one level shorter than this subtree, and what is left for the last level
+  size_t full = 1;
+  while (2 * full + 1 <= count)
+    full = 2 * full + 1;
+  size_t lastLevel = count - full;
+
+  // The left subtree gets half of the full levels and fills the last level first
+  size_t half = (full + 1) / 2;
+  size_t leftCount = (half - 1) + std::min(lastLevel, half);
+
+  size_t middle = _first + leftCount; // This node becomes the root
+  BinTree root = _nodes[middle];
+
+  root->left = LinkBalanced(_nodes, _first, middle);     // Smaller part on the left
+  root->right = LinkBalanced(_nodes, middle + 1, _last); // Larger part on the right
+
+  update_node(root); // Refresh the count and height from the linked children
+  root->balance_factor = tree_height(root->right) - tree_height(root->left);
+
+  return root;
+}
@@ -14,8 +14,14 @@ This file contains the declaration for the BSTree
 //---------------------------------------------------------------------------
 #include <string>    // std::string
 #include <stdexcept> // std::exception
+#include <algorithm> // std::max, std::sort
+#include <vector>    // std::vector
+#include <new>       // std::bad_alloc
+#include <type_traits> // std::is_trivially_destructible
 
 #include "ObjectAllocator.h"
+#include "BSTSnapshot.h"
+#include "NodeArena.h"
 
 /*!
   The exception class for the AVL/BST classes
@@ -82,17 +88,117 @@ class BSTree
       T data;             //!< The data
       int balance_factor; //!< optional for efficient balancing
       unsigned count;     //!< nodes in this subtree for efficient indexing
+      int height;         //!< height of this subtree for O(1) tree height
 
       //! Default constructor
-      BinTreeNode() : left(0), right(0), data(0), balance_factor(0), count(1) {};
+      BinTreeNode() : left(0), right(0), data(0), balance_factor(0), count(1), height(0) {};
 
       //! Conversion constructor
-      BinTreeNode(const T& value) : left(0), right(0), data(value), balance_factor(0), count(1) {};
+      BinTreeNode(const T& value) : left(0), right(0), data(value), balance_factor(0), count(1), height(0) {};
     };
 
     //! shorthand
     typedef BinTreeNode* BinTree;
 
+    /*!
+      In-order iterator over the values of a range. It keeps the path of nodes
+      that are still to be visited, so it only ever touches the nodes in the
+      range plus one path from the root.
+    */
+    class RangeIterator
+    {
+      public:
+        //! Creates an iterator positioned at the first value that is not less than low
+        RangeIterator(BinTree root, const T* low, const T* high) : high_(high)
+        {
+          while (root)
+          {
+            if (low && root->data < *low) // Too small, so is its left subtree
+              root = root->right;
+            else
+            {
+              path_.push_back(root); // Still to be visited after its left subtree
+              root = root->left;
+            }
+          }
+          stop_at_high();
+        }
+
+        //! The current value
+        const T& operator*() const { return path_.back()->data; }
+
+        //! The current value
+        const T* operator->() const { return &path_.back()->data; }
+
+        //! Moves on to the next value in order
+        RangeIterator& operator++()
+        {
+          BinTree node = path_.back()->right;
+          path_.pop_back();
+          while (node) // The leftmost node of the right subtree comes next
+          {
+            path_.push_back(node);
+            node = node->left;
+          }
+          stop_at_high();
+          return *this;
+        }
+
+        //! Both iterators are at the same node, or both are past the end
+        bool operator==(const RangeIterator& rhs) const
+        {
+          if (path_.empty() || rhs.path_.empty())
+            return path_.empty() == rhs.path_.empty();
+          return path_.back() == rhs.path_.back();
+        }
+
+        //! Not the same position
+        bool operator!=(const RangeIterator& rhs) const { return !(*this == rhs); }
+
+        //! Creates an iterator that is past the end
+        RangeIterator() : high_(0) {}
+
+      private:
+        //! Ends the iteration once the high end of the range is reached
+        void stop_at_high()
+        {
+          if (high_ && !path_.empty() && !(path_.back()->data < *high_))
+            path_.clear();
+        }
+
+        std::vector<BinTree> path_; //!< Nodes still to be visited, the current one last
+        const T* high_;             //!< Exclusive upper end of the range (0 means none)
+    };
+
+    /*!
+      The half-open range [low, high) of a tree, usable in a range-based for
+      loop. Values are produced lazily, so leaving the loop early also stops
+      the walk. The tree must not change while the range is in use.
+    */
+    class Range
+    {
+      public:
+        //! Creates the range [low, high), either end may be left open
+        Range(BinTree root, const T* low, const T* high) : root_(root),
+          low_(low ? *low : T()), high_(high ? *high : T()), has_low_(low != 0), has_high_(high != 0) {}
+
+        //! Iterator at the first value in the range
+        RangeIterator begin() const
+        {
+          return RangeIterator(root_, has_low_ ? &low_ : 0, has_high_ ? &high_ : 0);
+        }
+
+        //! Iterator past the last value in the range
+        RangeIterator end() const { return RangeIterator(); }
+
+      private:
+        BinTree root_;  //!< Root of the tree
+        T low_;         //!< Inclusive lower end
+        T high_;        //!< Exclusive upper end
+        bool has_low_;  //!< Whether there is a lower end
+        bool has_high_; //!< Whether there is an upper end
+    };
+
     BSTree(ObjectAllocator *oa = 0, bool ShareOA = false);
     BSTree(const BSTree& rhs);
     virtual ~BSTree();
@@ -101,34 +207,49 @@ class BSTree
     virtual void insert(const T& value);
     virtual void remove(const T& value);
     void clear();
-    bool find(const T& value, unsigned &compares) const;
+    template <typename Iter> void build_from_sorted(Iter first, Iter last);
+    template <typename Iter> void bulk_insert(Iter first, Iter last);
+    virtual bool find(const T& value, unsigned &compares) const;
     bool empty() const;
     unsigned int size() const;
     int height() const;
     BinTree root() const;
+    BSTSnapshot<T> freeze() const;
+    unsigned int rank(const T& value) const;
+    const BinTreeNode* lower_bound(const T& value) const;
+    const BinTreeNode* upper_bound(const T& value) const;
+    Range range(const T& low, const T& high) const;
+    Range prefix_range(const T& prefix) const;
 
   protected:
     BinTree& get_root();
     BinTree make_node(const T& value) const;
     void free_node(BinTree node);
     int tree_height(BinTree tree) const;
+    void update_node(BinTree node) const;
     void find_predecessor(BinTree tree, BinTree &predecessor) const;
+    virtual void rebuilding();
+    virtual void rebuilt();
 
     BinTree m_RootNode;
     unsigned int m_Size;
-    int m_Height;
     ObjectAllocator* m_OA;
     bool m_FreeOA;
     bool m_ShareOA;
+    mutable NodeArena<BinTreeNode> m_Arena; // used instead of m_OA when it is null
 
   private:
     // private stuff...
     void DeepCopyTree(const BinTree& _source, BinTree& _dest);
     void FreeTree(BinTree _tree);
-    void InsertNode(BinTree& _node, const T& _value, int _depth);
+    void ClearTree();
+    void DestroyTree(BinTree _tree);
+    void InsertNode(BinTree& _node, const T& _value);
     void DeleteNode(BinTree& _node, const T& _value);
     bool FindNode(BinTree _node, const T& _value, unsigned& _ompares) const;
     BinTree FindNodeAtIndex(BinTree _tree, unsigned _index) const;
+    void CollectNodes(BinTree _tree, std::vector<BinTree>& _nodes) const;
+    BinTree LinkBalanced(std::vector<BinTree>& _nodes, size_t _first, size_t _last) const;
 
 };
 
@@ -0,0 +1,677 @@
+/*!*************************************************************************
+\file BTree.cpp
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the implementation for the BTree
+***************************************************************************/
+#include "BTree.h"
+
+/*!*****************************************************************************
+ * @brief Constructs a B-tree with optional custom memory allocation.
+ *
+ * Initializes an empty B-tree, optionally using an external memory allocator.
+ * An external allocator must hand out blocks of sizeof(BTreeNode) bytes. If no
+ * allocator is provided, it creates a default one.
+ *
+ * @param _allocator A pointer to an ObjectAllocator to be used for node allocations.
+ * @param _shareAllocator Boolean indicating whether the allocator should be shared.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+BTree<T, Order>::BTree(ObjectAllocator *_allocator, bool _shareAllocator)
+    : m_RootNode{nullptr}, m_Size{0}, m_Height{-1}, m_ShareOA{_shareAllocator}
+{
+  if (_allocator)
+  {
+    m_OA = _allocator; // Use provided allocator
+    m_FreeOA = false; // Do not free OA as it's provided externally
+  }
+  else
+  {
+    OAConfig defaultConfig(true); // Create a default configuration for the allocator
+    m_OA = new ObjectAllocator(sizeof(BTreeNode), defaultConfig); // One block per node
+    m_FreeOA = true; // Set to free m_OA on destruction since it was created here
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Constructs a new BTree as a copy of an existing tree.
+ *
+ * This constructor creates a deep copy of an existing BTree. It either shares
+ * the ObjectAllocator with the source tree or creates a new one, depending on
+ * the sharing policy of the source tree.
+ *
+ * @param _rhs The source tree to copy from.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+BTree<T, Order>::BTree(const BTree &_rhs)
+    : m_RootNode{nullptr}, m_Size{0}, m_Height{-1}, m_ShareOA{_rhs.m_ShareOA}
+{
+  if (_rhs.m_ShareOA)
+  {
+    m_OA = _rhs.m_OA; // Share the ObjectAllocator from _rhs
+    m_FreeOA = false; // Do not free m_OA since it's shared
+  }
+  else
+  {
+    OAConfig defaultConfig(true); // Default configuration for the new allocator
+    m_OA = new ObjectAllocator(sizeof(BTreeNode), defaultConfig);
+    m_FreeOA = true; // Set to free m_OA on destruction since it was created here
+  }
+
+  m_RootNode = CopyTree(_rhs.m_RootNode);
+  m_Size = _rhs.m_Size;
+  m_Height = _rhs.m_Height;
+}
+
+/*!*****************************************************************************
+ * @brief Destroys the BTree, freeing all allocated resources.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+BTree<T, Order>::~BTree()
+{
+  clear(); // Free all nodes in the tree
+
+  if (m_FreeOA) // Only delete an allocator this tree created
+  {
+    delete m_OA;
+    m_OA = nullptr;
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Assigns a new value to the BTree, replacing its current content.
+ *
+ * The nodes of the right-hand side are deep copied. The ObjectAllocator is
+ * handled the same way as BSTree::operator= handles it.
+ *
+ * @param _rhs The source tree to copy from.
+ * @return A reference to the current tree after copying.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+BTree<T, Order> &BTree<T, Order>::operator=(const BTree &_rhs)
+{
+  if (this == &_rhs) // Check for self-assignment
+    return *this;
+
+  clear(); // The old nodes belong to the old allocator
+
+  if (_rhs.m_ShareOA)
+  {
+    if (m_FreeOA) // Drop the allocator this tree created
+      delete m_OA;
+
+    m_OA = _rhs.m_OA;
+    m_FreeOA = false; // Current tree should not delete the shared allocator
+    m_ShareOA = true; // Current tree is now sharing the allocator
+  }
+
+  m_RootNode = CopyTree(_rhs.m_RootNode);
+  m_Size = _rhs.m_Size;
+  m_Height = _rhs.m_Height;
+
+  return *this;
+}
+
+/*!*****************************************************************************
+ * @brief Accesses the value at the specified index in the BTree.
+ *
+ * Every node caches the number of keys in its subtree, so the walk skips whole
+ * children at a time and takes O(height * Order) steps.
+ *
+ * @param _index The zero-based index of the value to access.
+ * @return A const pointer to the value at the specified index, or nullptr if
+ *         the index is out of bounds.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+const T *BTree<T, Order>::operator[](int _index) const
+{
+  if (static_cast<unsigned>(_index) >= m_Size)
+    return nullptr; // Return nullptr if the index is invalid
+
+  unsigned index = static_cast<unsigned>(_index);
+  BNode node = m_RootNode;
+  while (!node->leaf)
+  {
+    unsigned i = 0;
+    for (; i < node->keys; ++i)
+    {
+      unsigned before = node->child[i]->count; // Keys in the child before data[i]
+      if (index < before) // The value is in this child
+        break;
+      if (index == before) // The value is the separator itself
+        return &node->data[i];
+      index -= before + 1; // Skip the child and the separator
+    }
+    node = node->child[i];
+  }
+
+  return &node->data[index];
+}
+
+/*!*****************************************************************************
+ * @brief Inserts a new value into the BTree.
+ *
+ * Full nodes are split on the way down, so there is always room for the new key
+ * when the leaf is reached. When the root is full, it is split first and the
+ * tree grows one level taller. Duplicate values are ignored.
+ *
+ * @param _value The value to be inserted into the tree.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::insert(const T &_value)
+{
+  if (m_RootNode == nullptr) // First value: a single leaf
+  {
+    m_RootNode = MakeNode(true);
+    m_RootNode->data[0] = _value;
+    m_RootNode->keys = 1;
+    m_RootNode->count = 1;
+    m_Size = 1;
+    m_Height = 0;
+    return;
+  }
+
+  if (m_RootNode->keys == MAX_KEYS) // Split the root before going down
+  {
+    BNode newRoot = MakeNode(false);
+    newRoot->child[0] = m_RootNode;
+    newRoot->count = m_RootNode->count;
+    try
+    {
+      SplitChild(newRoot, 0);
+    }
+    catch (const BSTException &)
+    {
+      FreeNode(newRoot); // The old root is untouched
+      throw;
+    }
+    m_RootNode = newRoot;
+    ++m_Height;
+  }
+
+  if (InsertNonFull(m_RootNode, _value))
+    ++m_Size;
+}
+
+/*!*****************************************************************************
+ * @brief Removes a value from the BTree, if it exists.
+ *
+ * Every child is refilled to at least MIN_KEYS + 1 keys before the walk goes
+ * into it, so a key can always be taken out of the leaf it ends in. When the
+ * root runs out of keys, its only child becomes the new root and the tree gets
+ * one level shorter.
+ *
+ * @param _value The value to be removed from the tree.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::remove(const T &_value)
+{
+  if (m_RootNode == nullptr)
+    return;
+
+  if (RemoveKey(m_RootNode, _value))
+    --m_Size;
+
+  if (m_RootNode->keys == 0) // Can happen after a merge even if the value was missing
+  {
+    BNode oldRoot = m_RootNode;
+    m_RootNode = oldRoot->leaf ? nullptr : oldRoot->child[0];
+    --m_Height;
+    FreeNode(oldRoot);
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Clears the BTree, removing all nodes.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::clear()
+{
+  if (m_RootNode)
+  {
+    FreeTree(m_RootNode); // Free all nodes starting from the root
+    m_RootNode = nullptr;
+    m_Size = 0;
+    m_Height = -1;
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Searches for a value in the BTree, tracking the number of comparisons.
+ *
+ * Each node is binary searched. Unlike BSTree::find, which counts one compare
+ * per node, the compares here are the actual key comparisons: those of the
+ * binary searches, plus one to check for a match in each node.
+ *
+ * @param _value The value to search for in the tree.
+ * @param _compares A reference to an unsigned variable where the function will
+ *                  add the number of comparisons made during the search.
+ * @return True if the value is found in the tree, false otherwise.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+bool BTree<T, Order>::find(const T &_value, unsigned &_compares) const
+{
+  BNode node = m_RootNode;
+  while (node)
+  {
+    unsigned i = LowerBound(node, _value, _compares); // First key not less than the value
+    if (i < node->keys)
+    {
+      ++_compares;
+      if (!(_value < node->data[i])) // Neither is less, so they are equal
+        return true;
+    }
+    node = node->leaf ? nullptr : node->child[i];
+  }
+
+  return false;
+}
+
+/*!*****************************************************************************
+ * @brief Checks if the BTree is empty.
+ *
+ * @return True if the tree has no keys, false otherwise.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+bool BTree<T, Order>::empty() const
+{
+  return m_Size == 0;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of keys in the BTree.
+ *
+ * @return The number of keys in the tree.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+unsigned int BTree<T, Order>::size() const
+{
+  return m_Size;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the height of the BTree.
+ *
+ * The height is the number of edges from the root to the leaves, all of which
+ * are at the same depth. An empty tree has a height of -1.
+ *
+ * @return The height of the tree.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+int BTree<T, Order>::height() const
+{
+  return m_Height;
+}
+
+/*!*****************************************************************************
+ * @brief Allocates and constructs an empty node.
+ *
+ * @param _leaf Whether the node is a leaf.
+ * @return A pointer to the new node.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+typename BTree<T, Order>::BNode BTree<T, Order>::MakeNode(bool _leaf) const
+{
+  try
+  {
+    BNode memory = reinterpret_cast<BNode>(m_OA->Allocate());
+    return new (memory) BTreeNode(_leaf); // Construct the node in place
+  }
+  catch (const OAException &except)
+  {
+    throw BSTException(BSTException::E_NO_MEMORY, except.what());
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Destroys a node and gives its memory back to the allocator.
+ *
+ * @param _node The node to free.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::FreeNode(BNode _node)
+{
+  _node->~BTreeNode();
+  m_OA->Free(_node);
+}
+
+/*!*****************************************************************************
+ * @brief Recursively frees all nodes of a subtree.
+ *
+ * @param _tree The root of the subtree to free.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::FreeTree(BNode _tree)
+{
+  if (!_tree->leaf)
+  {
+    for (unsigned i = 0; i <= _tree->keys; ++i)
+      FreeTree(_tree->child[i]);
+  }
+  FreeNode(_tree);
+}
+
+/*!*****************************************************************************
+ * @brief Recursively copies a subtree.
+ *
+ * If an allocation fails, the part of the copy made so far is freed and the
+ * exception is passed on.
+ *
+ * @param _source The root of the subtree to copy.
+ * @return The root of the copy.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+typename BTree<T, Order>::BNode BTree<T, Order>::CopyTree(BNode _source)
+{
+  if (_source == nullptr)
+    return nullptr;
+
+  BNode copy = MakeNode(_source->leaf);
+  std::copy(_source->data, _source->data + _source->keys, copy->data);
+  copy->keys = _source->keys;
+  copy->count = _source->count;
+
+  if (!_source->leaf)
+  {
+    unsigned i = 0;
+    try
+    {
+      for (; i <= _source->keys; ++i)
+        copy->child[i] = CopyTree(_source->child[i]);
+    }
+    catch (const BSTException &)
+    {
+      copy->keys = i ? i - 1 : 0; // Only children [0, i) were copied
+      copy->leaf = (i == 0);
+      FreeTree(copy);
+      throw;
+    }
+  }
+
+  return copy;
+}
+
+/*!*****************************************************************************
+ * @brief Binary searches a node for the first key that is not less than a value.
+ *
+ * @param _node The node to search.
+ * @param _value The value to search for.
+ * @param _compares Incremented once per key comparison.
+ * @return The index of the first key not less than _value, or the number of keys.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+unsigned BTree<T, Order>::LowerBound(BNode _node, const T &_value, unsigned &_compares) const
+{
+  unsigned low = 0, high = _node->keys;
+  while (low < high)
+  {
+    unsigned mid = (low + high) / 2;
+    ++_compares;
+    if (_node->data[mid] < _value) // The answer is to the right of mid
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return low;
+}
+
+/*!*****************************************************************************
+ * @brief Inserts a value below a node that is known not to be full.
+ *
+ * @param _node A node with fewer than MAX_KEYS keys.
+ * @param _value The value to insert.
+ * @return True if the value was inserted, false if it was already in the tree.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+bool BTree<T, Order>::InsertNonFull(BNode _node, const T &_value)
+{
+  unsigned compares = 0;
+  unsigned i = LowerBound(_node, _value, compares);
+  if (i < _node->keys && !(_value < _node->data[i])) // Already there
+    return false;
+
+  if (_node->leaf) // Make room at i and store the value there
+  {
+    std::move_backward(_node->data + i, _node->data + _node->keys, _node->data + _node->keys + 1);
+    _node->data[i] = _value;
+    ++_node->keys;
+    ++_node->count;
+    return true;
+  }
+
+  if (_node->child[i]->keys == MAX_KEYS) // Split a full child before going into it
+  {
+    SplitChild(_node, i);
+    if (_node->data[i] < _value) // The value belongs in the new right half
+      ++i;
+    else if (!(_value < _node->data[i])) // The value was the median that moved up
+      return false;
+  }
+
+  if (!InsertNonFull(_node->child[i], _value))
+    return false;
+
+  ++_node->count; // One more key in this subtree
+  return true;
+}
+
+/*!*****************************************************************************
+ * @brief Splits a full child into two half-full nodes.
+ *
+ * The upper half of the child's keys moves into a new node, and the median key
+ * moves up into the parent between the two halves. The parent must not be full.
+ *
+ * @param _parent The parent of the full child.
+ * @param _index The index of the full child in the parent.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::SplitChild(BNode _parent, unsigned _index)
+{
+  BNode full = _parent->child[_index];
+  BNode right = MakeNode(full->leaf); // Allocate before changing anything
+  const unsigned half = Order / 2;    // Keys [half, MAX_KEYS) move right, half - 1 is the median
+
+  std::move(full->data + half, full->data + MAX_KEYS, right->data);
+  right->keys = MAX_KEYS - half;
+  right->count = right->keys;
+  if (!full->leaf)
+  {
+    std::copy(full->child + half, full->child + Order, right->child);
+    for (unsigned i = 0; i <= right->keys; ++i)
+      right->count += right->child[i]->count;
+  }
+  full->keys = half - 1;
+  full->count -= right->count + 1; // The median leaves too
+
+  // Open a gap for the median and the new child in the parent
+  std::move_backward(_parent->data + _index, _parent->data + _parent->keys, _parent->data + _parent->keys + 1);
+  std::copy_backward(_parent->child + _index + 1, _parent->child + _parent->keys + 1, _parent->child + _parent->keys + 2);
+  _parent->data[_index] = std::move(full->data[half - 1]);
+  _parent->child[_index + 1] = right;
+  ++_parent->keys;
+}
+
+/*!*****************************************************************************
+ * @brief Removes a value from the subtree of a node.
+ *
+ * The node must have more than MIN_KEYS keys, unless it is the root. A key in
+ * an internal node is replaced by its predecessor or successor, which is then
+ * removed from the leaf it came from.
+ *
+ * @param _node The root of the subtree.
+ * @param _value The value to remove.
+ * @return True if the value was removed, false if it was not in the subtree.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+bool BTree<T, Order>::RemoveKey(BNode _node, const T &_value)
+{
+  unsigned compares = 0;
+  unsigned i = LowerBound(_node, _value, compares);
+  bool found = i < _node->keys && !(_value < _node->data[i]);
+
+  if (_node->leaf)
+  {
+    if (!found)
+      return false;
+
+    std::move(_node->data + i + 1, _node->data + _node->keys, _node->data + i); // Close the gap
+    --_node->keys;
+    --_node->count;
+    return true;
+  }
+
+  if (found)
+  {
+    if (_node->child[i]->keys > MIN_KEYS) // Replace with the predecessor
+    {
+      BNode leaf = _node->child[i];
+      while (!leaf->leaf)
+        leaf = leaf->child[leaf->keys];
+      _node->data[i] = leaf->data[leaf->keys - 1];
+      RemoveKey(_node->child[i], _node->data[i]);
+    }
+    else if (_node->child[i + 1]->keys > MIN_KEYS) // Replace with the successor
+    {
+      BNode leaf = _node->child[i + 1];
+      while (!leaf->leaf)
+        leaf = leaf->child[0];
+      _node->data[i] = leaf->data[0];
+      RemoveKey(_node->child[i + 1], _node->data[i]);
+    }
+    else // Both neighbours are minimal, merge them around the key and remove it there
+    {
+      MergeChildren(_node, i);
+      RemoveKey(_node->child[i], _value);
+    }
+    --_node->count;
+    return true;
+  }
+
+  if (_node->child[i]->keys == MIN_KEYS) // Make sure the child can lose a key
+    FillChild(_node, i);
+
+  if (!RemoveKey(_node->child[i], _value))
+    return false;
+
+  --_node->count; // One less key in this subtree
+  return true;
+}
+
+/*!*****************************************************************************
+ * @brief Gives a minimal child one more key.
+ *
+ * The key is borrowed through the parent from a sibling that can spare one. If
+ * neither sibling can, the child is merged with one of them, which may change
+ * the index of the child.
+ *
+ * @param _node The parent of the child.
+ * @param _index The index of the child, updated if the child was merged into its left sibling.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::FillChild(BNode _node, unsigned &_index)
+{
+  if (_index > 0 && _node->child[_index - 1]->keys > MIN_KEYS)
+    BorrowFromLeft(_node, _index);
+  else if (_index < _node->keys && _node->child[_index + 1]->keys > MIN_KEYS)
+    BorrowFromRight(_node, _index);
+  else if (_index < _node->keys)
+    MergeChildren(_node, _index);
+  else // The last child merges into its left sibling
+    MergeChildren(_node, --_index);
+}
+
+/*!*****************************************************************************
+ * @brief Rotates a key from the left sibling through the parent into a child.
+ *
+ * @param _node The parent of the child.
+ * @param _index The index of the child.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::BorrowFromLeft(BNode _node, unsigned _index)
+{
+  BNode child = _node->child[_index];
+  BNode sibling = _node->child[_index - 1];
+
+  // The separator moves down to the front of the child
+  std::move_backward(child->data, child->data + child->keys, child->data + child->keys + 1);
+  child->data[0] = std::move(_node->data[_index - 1]);
+  _node->data[_index - 1] = std::move(sibling->data[sibling->keys - 1]); // The sibling's last key moves up
+
+  unsigned moved = 1; // Keys that change subtree
+  if (!child->leaf) // The sibling's last child comes along
+  {
+    std::copy_backward(child->child, child->child + child->keys + 1, child->child + child->keys + 2);
+    child->child[0] = sibling->child[sibling->keys];
+    moved += child->child[0]->count;
+  }
+
+  ++child->keys;
+  --sibling->keys;
+  child->count += moved;
+  sibling->count -= moved;
+}
+
+/*!*****************************************************************************
+ * @brief Rotates a key from the right sibling through the parent into a child.
+ *
+ * @param _node The parent of the child.
+ * @param _index The index of the child.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::BorrowFromRight(BNode _node, unsigned _index)
+{
+  BNode child = _node->child[_index];
+  BNode sibling = _node->child[_index + 1];
+
+  // The separator moves down to the back of the child
+  child->data[child->keys] = std::move(_node->data[_index]);
+  _node->data[_index] = std::move(sibling->data[0]); // The sibling's first key moves up
+  std::move(sibling->data + 1, sibling->data + sibling->keys, sibling->data);
+
+  unsigned moved = 1; // Keys that change subtree
+  if (!child->leaf) // The sibling's first child comes along
+  {
+    child->child[child->keys + 1] = sibling->child[0];
+    moved += sibling->child[0]->count;
+    std::copy(sibling->child + 1, sibling->child + sibling->keys + 1, sibling->child);
+  }
+
+  ++child->keys;
+  --sibling->keys;
+  child->count += moved;
+  sibling->count -= moved;
+}
+
+/*!*****************************************************************************
+ * @brief Merges two minimal children and the separator between them.
+ *
+ * The right child and the separator are appended to the left child, which ends
+ * up full, and the right child is freed.
+ *
+ * @param _node The parent of the children.
+ * @param _index The index of the left child.
+ *******************************************************************************/
+template <typename T, unsigned Order>
+void BTree<T, Order>::MergeChildren(BNode _node, unsigned _index)
+{
+  BNode left = _node->child[_index];
+  BNode right = _node->child[_index + 1];
+
+  left->data[left->keys] = std::move(_node->data[_index]); // The separator goes between the halves
+  std::move(right->data, right->data + right->keys, left->data + left->keys + 1);
+  if (!left->leaf)
+    std::copy(right->child, right->child + right->keys + 1, left->child + left->keys + 1);
+  left->keys += right->keys + 1;
+  left->count += right->count + 1;
+
+  // Close the gap in the parent
+  std::move(_node->data + _index + 1, _node->data + _node->keys, _node->data + _index);
+  std::copy(_node->child + _index + 2, _node->child + _node->keys + 1, _node->child + _index + 1);
+  --_node->keys;
+
+  FreeNode(right);
+}
@@ -0,0 +1,98 @@
+/*!*************************************************************************
+\file BTree.h
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the declaration for the BTree, an ordered set that keeps
+many keys in each node to reduce the height of the tree
+***************************************************************************/
+//---------------------------------------------------------------------------
+#ifndef BTREE_H
+#define BTREE_H
+//---------------------------------------------------------------------------
+#include <algorithm> // std::move, std::move_backward
+#include "BSTree.h"  // BSTException, ObjectAllocator
+
+/*!
+  Definition for the B-tree.
+
+  Every node holds up to Order - 1 sorted keys and, unless it is a leaf,
+  Order children. Every node but the root is at least half full and all
+  leaves are at the same depth, so the height is about log(n) / log(Order / 2)
+  and a lookup touches a few wide nodes instead of many small ones. Nodes are
+  split on the way down during insert and refilled on the way down during
+  remove, so neither ever has to walk back up.
+
+  The public interface matches BSTree, except that operator[] returns the
+  value itself since there is no node per value.
+*/
+template <typename T, unsigned Order = 32>
+class BTree
+{
+  static_assert(Order >= 4 && Order % 2 == 0, "Order must be even and at least 4");
+
+  public:
+    //! Most keys a node can hold
+    static const unsigned MAX_KEYS = Order - 1;
+
+    //! Fewest keys a node other than the root can hold
+    static const unsigned MIN_KEYS = Order / 2 - 1;
+
+    //! The node structure
+    struct BTreeNode
+    {
+      unsigned keys;            //!< Number of keys in use
+      unsigned count;           //!< Keys in this subtree for efficient indexing
+      bool leaf;                //!< Whether the node has no children
+      T data[MAX_KEYS];         //!< The keys, sorted
+      BTreeNode *child[Order];  //!< child[i] holds the keys between data[i - 1] and data[i]
+
+      //! Default constructor
+      BTreeNode(bool isLeaf) : keys(0), count(0), leaf(isLeaf), data(), child() {};
+    };
+
+    //! shorthand
+    typedef BTreeNode* BNode;
+
+    BTree(ObjectAllocator *oa = 0, bool ShareOA = false);
+    BTree(const BTree& rhs);
+    ~BTree();
+    BTree& operator=(const BTree& rhs);
+    const T* operator[](int index) const;
+    void insert(const T& value);
+    void remove(const T& value);
+    void clear();
+    bool find(const T& value, unsigned &compares) const;
+    bool empty() const;
+    unsigned int size() const;
+    int height() const;
+
+  private:
+    BNode MakeNode(bool _leaf) const;
+    void FreeNode(BNode _node);
+    void FreeTree(BNode _tree);
+    BNode CopyTree(BNode _source);
+    unsigned LowerBound(BNode _node, const T& _value, unsigned& _compares) const;
+    bool InsertNonFull(BNode _node, const T& _value);
+    void SplitChild(BNode _parent, unsigned _index);
+    bool RemoveKey(BNode _node, const T& _value);
+    void FillChild(BNode _node, unsigned& _index);
+    void BorrowFromLeft(BNode _node, unsigned _index);
+    void BorrowFromRight(BNode _node, unsigned _index);
+    void MergeChildren(BNode _node, unsigned _index);
+
+    BNode m_RootNode;      //!< The root, nullptr when empty
+    unsigned int m_Size;   //!< Number of keys in the tree
+    int m_Height;          //!< Edges from the root to the leaves, -1 when empty
+    ObjectAllocator* m_OA; //!< Allocator for the nodes
+    bool m_FreeOA;         //!< Whether the allocator is owned by this tree
+    bool m_ShareOA;        //!< Whether copies share the allocator
+};
+
+#include "BTree.cpp"
+
+#endif
+//---------------------------------------------------------------------------
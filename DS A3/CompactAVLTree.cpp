@@ -0,0 +1,524 @@
+/*!*************************************************************************
+\file CompactAVLTree.cpp
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the implementation for the CompactAVLTree
+***************************************************************************/
+#include "CompactAVLTree.h"
+
+/*!*****************************************************************************
+ * @brief Constructs an empty compact AVL tree.
+ *******************************************************************************/
+template <typename T>
+CompactAVLTree<T>::CompactAVLTree()
+    : m_Nodes(1), m_RootNode{NIL}, m_FreeList{NIL}
+{
+}
+
+/*!*****************************************************************************
+ * @brief Inserts a new value into the tree.
+ *
+ * The tree is rebalanced on the way back up, and the walk stops adjusting
+ * balance factors as soon as a subtree did not grow. Duplicate values are
+ * ignored.
+ *
+ * @param _value The value to be inserted into the tree.
+ *******************************************************************************/
+template <typename T>
+void CompactAVLTree<T>::insert(const T &_value)
+{
+  if (Count(m_RootNode) == MAX_COUNT) // The count would not fit in meta any more
+    throw BSTException(BSTException::E_NO_MEMORY, "CompactAVLTree is full");
+
+  bool grew = false, added = false;
+  m_RootNode = InsertNode(m_RootNode, _value, grew, added);
+}
+
+/*!*****************************************************************************
+ * @brief Removes a value from the tree, if it exists.
+ *
+ * @param _value The value to be removed from the tree.
+ *******************************************************************************/
+template <typename T>
+void CompactAVLTree<T>::remove(const T &_value)
+{
+  bool shrank = false, removed = false;
+  m_RootNode = DeleteNode(m_RootNode, _value, shrank, removed);
+}
+
+/*!*****************************************************************************
+ * @brief Clears the tree and gives back the memory of its nodes.
+ *******************************************************************************/
+template <typename T>
+void CompactAVLTree<T>::clear()
+{
+  std::vector<CompactNode>(1).swap(m_Nodes); // Only the empty tree is left
+  m_RootNode = NIL;
+  m_FreeList = NIL;
+}
+
+/*!*****************************************************************************
+ * @brief Searches for a value in the tree, tracking the number of comparisons.
+ *
+ * The compares are counted like BSTree::find counts them, one per node on the
+ * path plus one for the empty subtree when the value is missing. The next child
+ * is picked with a conditional select, since on random lookups the direction
+ * taken at each level is a coin flip that the branch predictor cannot learn.
+ *
+ * @param _value The value to search for in the tree.
+ * @param _compares A reference to an unsigned variable where the function will
+ *                  add the number of comparisons made during the search.
+ * @return True if the value is found in the tree, false otherwise.
+ *******************************************************************************/
+template <typename T>
+bool CompactAVLTree<T>::find(const T &_value, unsigned &_compares) const
+{
+  const CompactNode *nodes = m_Nodes.data();
+  Index node = m_RootNode;
+
+  while (node != NIL)
+  {
+    ++_compares;
+    const CompactNode &current = nodes[node];
+    if (_value == current.data)
+      return true;
+    node = (_value < current.data) ? current.left : current.right; // A select, not a hard-to-predict branch
+  }
+
+  ++_compares; // The empty subtree
+  return false;
+}
+
+/*!*****************************************************************************
+ * @brief Accesses the value at the specified index in the tree.
+ *
+ * @param _index The zero-based index of the value to access.
+ * @return A const pointer to the value at the specified index, or nullptr if
+ *         the index is out of bounds.
+ *******************************************************************************/
+template <typename T>
+const T *CompactAVLTree<T>::operator[](int _index) const
+{
+  if (static_cast<unsigned>(_index) >= size())
+    return nullptr; // Return nullptr if the index is invalid
+
+  unsigned index = static_cast<unsigned>(_index);
+  Index node = m_RootNode;
+  for (;;)
+  {
+    unsigned leftCount = Count(m_Nodes[node].left); // The empty tree counts 0
+    if (index < leftCount)
+      node = m_Nodes[node].left;
+    else if (index > leftCount)
+    {
+      index -= leftCount + 1; // Skip the left subtree and the node
+      node = m_Nodes[node].right;
+    }
+    else
+      return &m_Nodes[node].data;
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Checks if the tree is empty.
+ *
+ * @return True if the tree has no values, false otherwise.
+ *******************************************************************************/
+template <typename T>
+bool CompactAVLTree<T>::empty() const
+{
+  return m_RootNode == NIL;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of values in the tree.
+ *
+ * @return The number of values in the tree.
+ *******************************************************************************/
+template <typename T>
+unsigned int CompactAVLTree<T>::size() const
+{
+  return Count(m_RootNode);
+}
+
+/*!*****************************************************************************
+ * @brief Returns the height of the tree.
+ *
+ * Nodes do not store their height, but the balance factors show which child is
+ * taller, so following them from the root finds the longest path in O(log n).
+ * An empty tree has a height of -1.
+ *
+ * @return The height of the tree.
+ *******************************************************************************/
+template <typename T>
+int CompactAVLTree<T>::height() const
+{
+  int height = -1;
+  Index node = m_RootNode;
+  while (node != NIL)
+  {
+    ++height;
+    node = (Balance(node) < 0) ? m_Nodes[node].left : m_Nodes[node].right; // Go to the taller side
+  }
+  return height;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the memory held by the node array.
+ *
+ * @return The number of bytes reserved for nodes, in use or not.
+ *******************************************************************************/
+template <typename T>
+size_t CompactAVLTree<T>::memory_used() const
+{
+  return m_Nodes.capacity() * sizeof(CompactNode);
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of nodes in a subtree.
+ *
+ * @param _node The root of the subtree.
+ * @return The count stored in the node, 0 for the empty tree.
+ *******************************************************************************/
+template <typename T>
+unsigned CompactAVLTree<T>::Count(Index _node) const
+{
+  return m_Nodes[_node].meta >> 2;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the balance factor of a node.
+ *
+ * @param _node The node.
+ * @return The height of the right subtree minus the height of the left one.
+ *******************************************************************************/
+template <typename T>
+int CompactAVLTree<T>::Balance(Index _node) const
+{
+  return static_cast<int>(m_Nodes[_node].meta & 3u) - 1;
+}
+
+/*!*****************************************************************************
+ * @brief Packs the count and the balance factor of a node.
+ *
+ * @param _node The node.
+ * @param _count The number of nodes in its subtree.
+ * @param _balance Its balance factor, from -1 to 1.
+ *******************************************************************************/
+template <typename T>
+void CompactAVLTree<T>::SetMeta(Index _node, unsigned _count, int _balance)
+{
+  m_Nodes[_node].meta = (_count << 2) | static_cast<uint32_t>(_balance + 1);
+}
+
+/*!*****************************************************************************
+ * @brief Takes a node from the free list, or appends one to the array.
+ *
+ * Appending may move the array, so callers must not hold references to nodes
+ * across this call, only indices.
+ *
+ * @param _value The value of the new node.
+ * @return The index of the new node.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::Allocate(const T &_value)
+{
+  Index node = m_FreeList;
+  if (node != NIL) // Reuse a freed node
+    m_FreeList = m_Nodes[node].left;
+  else
+  {
+    try
+    {
+      m_Nodes.push_back(CompactNode());
+    }
+    catch (const std::bad_alloc &except)
+    {
+      throw BSTException(BSTException::E_NO_MEMORY, except.what());
+    }
+    node = static_cast<Index>(m_Nodes.size() - 1);
+  }
+
+  m_Nodes[node].data = _value;
+  m_Nodes[node].left = NIL;
+  m_Nodes[node].right = NIL;
+  SetMeta(node, 1, 0); // A leaf is balanced
+  return node;
+}
+
+/*!*****************************************************************************
+ * @brief Puts a node on the free list.
+ *
+ * @param _node The node to free.
+ *******************************************************************************/
+template <typename T>
+void CompactAVLTree<T>::Release(Index _node)
+{
+  m_Nodes[_node].data = T(); // Drop anything the value owns
+  m_Nodes[_node].left = m_FreeList;
+  m_Nodes[_node].meta = 0;
+  m_FreeList = _node;
+}
+
+/*!*****************************************************************************
+ * @brief Recursively inserts a value and rebalances on the way back.
+ *
+ * @param _node The root of the subtree.
+ * @param _value The value to insert.
+ * @param _grew Set to whether the subtree got taller.
+ * @param _added Set to whether the value was added.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::InsertNode(Index _node, const T &_value, bool &_grew, bool &_added)
+{
+  if (_node == NIL) // Base case: the value goes here
+  {
+    _grew = true;
+    _added = true;
+    return Allocate(_value);
+  }
+
+  int balance = Balance(_node);
+  if (_value < m_Nodes[_node].data)
+  {
+    Index child = InsertNode(m_Nodes[_node].left, _value, _grew, _added);
+    m_Nodes[_node].left = child; // Assign after the call, the array may have moved
+    if (_grew)
+      --balance; // The left side got taller
+  }
+  else if (m_Nodes[_node].data < _value)
+  {
+    Index child = InsertNode(m_Nodes[_node].right, _value, _grew, _added);
+    m_Nodes[_node].right = child; // Assign after the call, the array may have moved
+    if (_grew)
+      ++balance; // The right side got taller
+  }
+  else // Already in the tree
+    return _node;
+
+  if (!_added)
+    return _node;
+
+  if (balance == 2 || balance == -2) // A rotation restores the height it had before
+  {
+    _grew = false;
+    return Rebalance(_node, balance);
+  }
+
+  SetMeta(_node, Count(_node) + 1, balance);
+  if (balance == 0) // The shorter side caught up
+    _grew = false;
+  return _node;
+}
+
+/*!*****************************************************************************
+ * @brief Recursively removes a value and rebalances on the way back.
+ *
+ * A node with two children is replaced by its predecessor node, which is
+ * relinked rather than copied.
+ *
+ * @param _node The root of the subtree.
+ * @param _value The value to remove.
+ * @param _shrank Set to whether the subtree got shorter.
+ * @param _removed Set to whether the value was removed.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::DeleteNode(Index _node, const T &_value, bool &_shrank, bool &_removed)
+{
+  if (_node == NIL) // Base case: not in the tree
+    return NIL;
+
+  if (_value < m_Nodes[_node].data)
+  {
+    m_Nodes[_node].left = DeleteNode(m_Nodes[_node].left, _value, _shrank, _removed);
+    if (!_removed)
+      return _node;
+    SetMeta(_node, Count(_node) - 1, Balance(_node));
+    return _shrank ? LeftShrank(_node, _shrank) : _node;
+  }
+
+  if (m_Nodes[_node].data < _value)
+  {
+    m_Nodes[_node].right = DeleteNode(m_Nodes[_node].right, _value, _shrank, _removed);
+    if (!_removed)
+      return _node;
+    SetMeta(_node, Count(_node) - 1, Balance(_node));
+    return _shrank ? RightShrank(_node, _shrank) : _node;
+  }
+
+  _removed = true;
+  Index left = m_Nodes[_node].left;
+  Index right = m_Nodes[_node].right;
+
+  if (left == NIL || right == NIL) // At most one child, which takes its place
+  {
+    Release(_node);
+    _shrank = true;
+    return (left != NIL) ? left : right;
+  }
+
+  // Two children: the predecessor takes the place of the node
+  Index pred = NIL;
+  Index newLeft = DetachMax(left, _shrank, pred);
+  m_Nodes[pred].left = newLeft;
+  m_Nodes[pred].right = right;
+  SetMeta(pred, Count(_node) - 1, Balance(_node));
+  Release(_node);
+  return _shrank ? LeftShrank(pred, _shrank) : pred;
+}
+
+/*!*****************************************************************************
+ * @brief Unlinks the largest node of a subtree.
+ *
+ * @param _node The root of the subtree.
+ * @param _shrank Set to whether the subtree got shorter.
+ * @param _max Set to the unlinked node.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::DetachMax(Index _node, bool &_shrank, Index &_max)
+{
+  if (m_Nodes[_node].right == NIL) // The largest node, its left child takes its place
+  {
+    _max = _node;
+    _shrank = true;
+    return m_Nodes[_node].left;
+  }
+
+  m_Nodes[_node].right = DetachMax(m_Nodes[_node].right, _shrank, _max);
+  SetMeta(_node, Count(_node) - 1, Balance(_node));
+  return _shrank ? RightShrank(_node, _shrank) : _node;
+}
+
+/*!*****************************************************************************
+ * @brief Updates a node whose left subtree got shorter.
+ *
+ * @param _node The node.
+ * @param _shrank Set to whether the node's subtree got shorter as well.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::LeftShrank(Index _node, bool &_shrank)
+{
+  int balance = Balance(_node) + 1;
+  if (balance == 2) // The height drops unless the right child was balanced
+  {
+    Index root = Rebalance(_node, balance);
+    _shrank = (Balance(root) == 0);
+    return root;
+  }
+
+  SetMeta(_node, Count(_node), balance);
+  _shrank = (balance == 0); // Was left-heavy, so the left side held the height
+  return _node;
+}
+
+/*!*****************************************************************************
+ * @brief Updates a node whose right subtree got shorter.
+ *
+ * @param _node The node.
+ * @param _shrank Set to whether the node's subtree got shorter as well.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::RightShrank(Index _node, bool &_shrank)
+{
+  int balance = Balance(_node) - 1;
+  if (balance == -2) // The height drops unless the left child was balanced
+  {
+    Index root = Rebalance(_node, balance);
+    _shrank = (Balance(root) == 0);
+    return root;
+  }
+
+  SetMeta(_node, Count(_node), balance);
+  _shrank = (balance == 0); // Was right-heavy, so the right side held the height
+  return _node;
+}
+
+/*!*****************************************************************************
+ * @brief Rebalances a node that is two levels heavier on one side.
+ *
+ * Two bits cannot hold a balance factor of -2 or +2, so it is passed in rather
+ * than read from the node, and the balance factors after the single or double
+ * rotation are worked out here from those of the child and grandchild. The
+ * count of the node may be stale, the rotations recompute it.
+ *
+ * @param _node The unbalanced node.
+ * @param _balance Its balance factor, -2 or +2.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::Rebalance(Index _node, int _balance)
+{
+  if (_balance > 0) // Right-heavy
+  {
+    Index right = m_Nodes[_node].right;
+    int rightBalance = Balance(right);
+    if (rightBalance >= 0) // Right-right case
+      return LeftRotation(_node, 1 - rightBalance, rightBalance - 1);
+
+    // Right-left case, the grandchild ends up on top and balanced
+    Index middle = m_Nodes[right].left;
+    int middleBalance = Balance(middle);
+    m_Nodes[_node].right = RightRotation(right, (middleBalance < 0) ? 1 : 0, 0);
+    return LeftRotation(_node, (middleBalance > 0) ? -1 : 0, 0);
+  }
+
+  Index left = m_Nodes[_node].left;
+  int leftBalance = Balance(left);
+  if (leftBalance <= 0) // Left-left case
+    return RightRotation(_node, -1 - leftBalance, leftBalance + 1);
+
+  // Left-right case, the grandchild ends up on top and balanced
+  Index middle = m_Nodes[left].right;
+  int middleBalance = Balance(middle);
+  m_Nodes[_node].left = LeftRotation(left, (middleBalance > 0) ? -1 : 0, 0);
+  return RightRotation(_node, (middleBalance < 0) ? 1 : 0, 0);
+}
+
+/*!*****************************************************************************
+ * @brief Performs a left rotation.
+ *
+ * @param _node The root of the subtree to rotate.
+ * @param _nodeBalance The balance factor _node ends up with.
+ * @param _rootBalance The balance factor the new root ends up with.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::LeftRotation(Index _node, int _nodeBalance, int _rootBalance)
+{
+  Index newRoot = m_Nodes[_node].right;         // The right child becomes the new root
+  m_Nodes[_node].right = m_Nodes[newRoot].left; // Its left subtree moves under the old root
+  m_Nodes[newRoot].left = _node;                // The old root becomes its left child
+
+  SetMeta(_node, Count(m_Nodes[_node].left) + Count(m_Nodes[_node].right) + 1, _nodeBalance);
+  SetMeta(newRoot, Count(_node) + Count(m_Nodes[newRoot].right) + 1, _rootBalance);
+  return newRoot;
+}
+
+/*!*****************************************************************************
+ * @brief Performs a right rotation.
+ *
+ * @param _node The root of the subtree to rotate.
+ * @param _nodeBalance The balance factor _node ends up with.
+ * @param _rootBalance The balance factor the new root ends up with.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename CompactAVLTree<T>::Index CompactAVLTree<T>::RightRotation(Index _node, int _nodeBalance, int _rootBalance)
+{
+  Index newRoot = m_Nodes[_node].left;          // The left child becomes the new root
+  m_Nodes[_node].left = m_Nodes[newRoot].right; // Its right subtree moves under the old root
+  m_Nodes[newRoot].right = _node;               // The old root becomes its right child
+
+  SetMeta(_node, Count(m_Nodes[_node].left) + Count(m_Nodes[_node].right) + 1, _nodeBalance);
+  SetMeta(newRoot, Count(m_Nodes[newRoot].left) + Count(_node) + 1, _rootBalance);
+  return newRoot;
+}
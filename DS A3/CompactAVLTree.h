@@ -0,0 +1,94 @@
+/*!*************************************************************************
+\file CompactAVLTree.h
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the declaration for the CompactAVLTree, an AVL tree
+whose nodes live in one array and link to each other by 32-bit index
+***************************************************************************/
+//---------------------------------------------------------------------------
+#ifndef COMPACTAVLTREE_H
+#define COMPACTAVLTREE_H
+//---------------------------------------------------------------------------
+#include <vector>    // std::vector
+#include <new>       // std::bad_alloc
+#include <cstdint>   // uint32_t
+#include <cstddef>   // size_t
+#include "BSTree.h"  // BSTException
+
+/*!
+  Definition for the compact AVL tree.
+
+  A BinTreeNode holds two 8-byte child pointers and three 4-byte fields next
+  to its data, and each one is a separate allocation. Here every node is an
+  element of one growing array, the children are 32-bit indices into it
+  (index 0 is the empty tree) and the balance factor is packed into the top
+  two bits of the subtree count. A node of ints takes 16 bytes instead of 32,
+  so twice as many fit in each cache line and no per-node allocation header
+  is paid. Freed nodes are kept on a free list for reuse.
+
+  The interface matches AVLTree, except that operator[] returns the value
+  itself, and the tree can hold at most 2^30 - 1 values.
+*/
+template <typename T>
+class CompactAVLTree
+{
+  public:
+    //! Index of a node in the array, 0 means no node
+    typedef uint32_t Index;
+
+    //! The node structure
+    struct CompactNode
+    {
+      T data;        //!< The data
+      Index left;    //!< The left child (or the next free node)
+      Index right;   //!< The right child
+      uint32_t meta; //!< Nodes in this subtree << 2 | (balance factor + 1)
+
+      //! Default constructor
+      CompactNode() : data(), left(0), right(0), meta(0) {};
+    };
+
+    CompactAVLTree();
+    void insert(const T& value);
+    void remove(const T& value);
+    void clear();
+    bool find(const T& value, unsigned &compares) const;
+    const T* operator[](int index) const;
+    bool empty() const;
+    unsigned int size() const;
+    int height() const;
+    size_t memory_used() const;
+
+  private:
+    static const Index NIL = 0;       //!< The empty tree
+    static const uint32_t MAX_COUNT = (1u << 30) - 1; //!< Largest count that fits in meta
+
+    unsigned Count(Index _node) const;
+    int Balance(Index _node) const;
+    void SetMeta(Index _node, unsigned _count, int _balance);
+
+    Index Allocate(const T& _value);
+    void Release(Index _node);
+
+    Index InsertNode(Index _node, const T& _value, bool& _grew, bool& _added);
+    Index DeleteNode(Index _node, const T& _value, bool& _shrank, bool& _removed);
+    Index DetachMax(Index _node, bool& _shrank, Index& _max);
+    Index LeftShrank(Index _node, bool& _shrank);
+    Index RightShrank(Index _node, bool& _shrank);
+    Index Rebalance(Index _node, int _balance);
+    Index LeftRotation(Index _node, int _nodeBalance, int _rootBalance);
+    Index RightRotation(Index _node, int _nodeBalance, int _rootBalance);
+
+    std::vector<CompactNode> m_Nodes; //!< All nodes, m_Nodes[0] is the empty tree
+    Index m_RootNode;                 //!< The root, NIL when empty
+    Index m_FreeList;                 //!< First free node, linked through left
+};
+
+#include "CompactAVLTree.cpp"
+
+#endif
+//---------------------------------------------------------------------------
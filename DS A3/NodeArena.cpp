@@ -0,0 +1,118 @@
+/*!*************************************************************************
+\file NodeArena.cpp
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the implementation for the NodeArena
+***************************************************************************/
+#include "NodeArena.h"
+
+/*!*****************************************************************************
+ * @brief Constructs an empty arena, no memory is taken until the first node.
+ *******************************************************************************/
+template <typename Node>
+NodeArena<Node>::NodeArena()
+    : m_Blocks{}, m_Next{nullptr}, m_End{nullptr}, m_FreeList{nullptr}, m_NextBlock{FIRST_BLOCK}
+{
+}
+
+/*!*****************************************************************************
+ * @brief Destroys the arena, giving back all of its blocks.
+ *******************************************************************************/
+template <typename Node>
+NodeArena<Node>::~NodeArena()
+{
+  reset();
+}
+
+/*!*****************************************************************************
+ * @brief Returns storage for one node.
+ *
+ * A freed slot is reused first, then the rest of the current block, and only
+ * then is a new block taken from the heap.
+ *
+ * @return Uninitialized storage for a Node.
+ *******************************************************************************/
+template <typename Node>
+void *NodeArena<Node>::allocate()
+{
+  if (m_FreeList) // Reuse a freed slot
+  {
+    Slot *slot = m_FreeList;
+    m_FreeList = slot->next;
+    return slot;
+  }
+
+  if (m_Next == m_End) // The current block is used up
+    AddBlock(m_NextBlock);
+
+  return m_Next++;
+}
+
+/*!*****************************************************************************
+ * @brief Gives back the storage of one node, which must already be destroyed.
+ *
+ * @param _node Storage returned by allocate.
+ *******************************************************************************/
+template <typename Node>
+void NodeArena<Node>::free(void *_node)
+{
+  Slot *slot = static_cast<Slot *>(_node);
+  slot->next = m_FreeList;
+  m_FreeList = slot;
+}
+
+/*!*****************************************************************************
+ * @brief Makes sure the next count nodes come from a single block.
+ *
+ * This is used before copying a whole tree, so all the nodes of the copy are
+ * taken from the heap in one request and end up next to each other. The free
+ * list is ignored, since it may be scattered.
+ *
+ * @param _count The number of nodes about to be allocated.
+ *******************************************************************************/
+template <typename Node>
+void NodeArena<Node>::reserve(size_t _count)
+{
+  if (static_cast<size_t>(m_End - m_Next) < _count)
+    AddBlock(_count);
+}
+
+/*!*****************************************************************************
+ * @brief Gives back every block at once.
+ *
+ * All storage handed out becomes invalid. The nodes are not destroyed.
+ *******************************************************************************/
+template <typename Node>
+void NodeArena<Node>::reset()
+{
+  for (size_t i = 0; i < m_Blocks.size(); ++i)
+    ::operator delete(m_Blocks[i]);
+
+  m_Blocks.clear();
+  m_Next = m_End = m_FreeList = nullptr;
+  m_NextBlock = FIRST_BLOCK;
+}
+
+/*!*****************************************************************************
+ * @brief Takes a new block from the heap and makes it the current one.
+ *
+ * Whatever is left of the previous block is abandoned until the next reset.
+ *
+ * @param _count The number of nodes in the new block.
+ *******************************************************************************/
+template <typename Node>
+void NodeArena<Node>::AddBlock(size_t _count)
+{
+  m_Blocks.reserve(m_Blocks.size() + 1); // So push_back below cannot throw and leak the block
+  Slot *block = static_cast<Slot *>(::operator new(_count * sizeof(Slot)));
+  m_Blocks.push_back(block);
+  m_Next = block;
+  m_End = block + _count;
+
+  if (m_NextBlock < MAX_BLOCK) // Grow geometrically so there are O(log n) blocks
+    m_NextBlock *= 2;
+}
@@ -0,0 +1,64 @@
+/*!*************************************************************************
+\file NodeArena.h
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the declaration for the NodeArena, a block allocator
+for tree nodes that can give back all of its memory at once
+***************************************************************************/
+//---------------------------------------------------------------------------
+#ifndef NODEARENA_H
+#define NODEARENA_H
+//---------------------------------------------------------------------------
+#include <vector>  // std::vector
+#include <cstddef> // size_t
+#include <new>     // operator new, std::bad_alloc
+
+/*!
+  Hands out uninitialized storage for one Node at a time. The storage is cut
+  from large blocks, and freed nodes are kept on a free list for reuse.
+  reset() gives back every block in one go, without visiting the nodes, so
+  the caller must have destroyed them already if they need destroying.
+*/
+template <typename Node>
+class NodeArena
+{
+  public:
+    NodeArena();
+    ~NodeArena();
+    NodeArena(const NodeArena& rhs) = delete;
+    NodeArena& operator=(const NodeArena& rhs) = delete;
+
+    void* allocate();
+    void free(void* node);
+    void reserve(size_t count);
+    void reset();
+
+  private:
+    //! Storage for one node, or the link of the free list once it is freed
+    union Slot
+    {
+      Slot* next;                          //!< Next free slot
+      alignas(Node) char node[sizeof(Node)]; //!< The node itself
+    };
+
+    //! Nodes in the first block, later blocks double up to MAX_BLOCK
+    static const size_t FIRST_BLOCK = 64;
+    static const size_t MAX_BLOCK = 64 * 1024;
+
+    void AddBlock(size_t _count);
+
+    std::vector<Slot*> m_Blocks; //!< Every block, the current one last
+    Slot* m_Next;                //!< Next unused slot of the current block
+    Slot* m_End;                 //!< End of the current block
+    Slot* m_FreeList;            //!< Freed slots
+    size_t m_NextBlock;          //!< Nodes in the next block to be added
+};
+
+#include "NodeArena.cpp"
+
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,596 @@
+/*!*************************************************************************
+\file PersistentAVLTree.cpp
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the implementation for the PersistentAVLTree
+***************************************************************************/
+#include "PersistentAVLTree.h"
+
+/*!*****************************************************************************
+ * @brief Constructs an empty persistent AVL tree.
+ *
+ * An external allocator must hand out blocks of sizeof(PersistentNode) bytes
+ * and must outlive every version made from this tree. If no allocator is
+ * provided, a default one is created and deleted with the last version.
+ *
+ * @param _allocator A pointer to an ObjectAllocator to be used for node allocations.
+ *******************************************************************************/
+template <typename T>
+PersistentAVLTree<T>::PersistentAVLTree(ObjectAllocator *_allocator)
+    : m_Shared{new Shared}, m_RootNode{nullptr}
+{
+  if (_allocator)
+  {
+    m_Shared->oa = _allocator; // Use provided allocator
+    m_Shared->freeOA = false;  // Do not free OA as it's provided externally
+  }
+  else
+  {
+    OAConfig defaultConfig(true); // Create a default configuration for the allocator
+    try
+    {
+      m_Shared->oa = new ObjectAllocator(sizeof(PersistentNode), defaultConfig); // One block per node
+    }
+    catch (...)
+    {
+      delete m_Shared;
+      throw;
+    }
+    m_Shared->freeOA = true; // Deleted with the last version
+  }
+  m_Shared->refs = 1;
+  m_Shared->nodes = 0;
+}
+
+/*!*****************************************************************************
+ * @brief Constructs a snapshot of another version in O(1).
+ *
+ * No node is copied: the snapshot shares the root and the allocator of the
+ * source, and later updates to either one do not affect the other.
+ *
+ * @param _rhs The version to take a snapshot of.
+ *******************************************************************************/
+template <typename T>
+PersistentAVLTree<T>::PersistentAVLTree(const PersistentAVLTree &_rhs)
+    : m_Shared{_rhs.m_Shared}, m_RootNode{Retain(_rhs.m_RootNode)}
+{
+  ++m_Shared->refs;
+}
+
+/*!*****************************************************************************
+ * @brief Constructs a version around a root that was just built.
+ *
+ * @param _shared The state shared with the version the root was built from.
+ * @param _root The root; the new version takes over its reference.
+ *******************************************************************************/
+template <typename T>
+PersistentAVLTree<T>::PersistentAVLTree(Shared *_shared, PNode _root)
+    : m_Shared{_shared}, m_RootNode{_root}
+{
+  ++m_Shared->refs;
+}
+
+/*!*****************************************************************************
+ * @brief Destroys this version.
+ *
+ * Only the nodes that no other version uses are freed.
+ *******************************************************************************/
+template <typename T>
+PersistentAVLTree<T>::~PersistentAVLTree()
+{
+  clear();
+  ReleaseShared();
+}
+
+/*!*****************************************************************************
+ * @brief Makes this tree a snapshot of another version in O(1).
+ *
+ * @param _rhs The version to take a snapshot of.
+ * @return A reference to the current tree.
+ *******************************************************************************/
+template <typename T>
+PersistentAVLTree<T> &PersistentAVLTree<T>::operator=(const PersistentAVLTree &_rhs)
+{
+  PNode root = Retain(_rhs.m_RootNode); // First, in case both share the root
+  clear(); // The old nodes belong to the old allocator
+
+  if (m_Shared != _rhs.m_Shared)
+  {
+    ReleaseShared();
+    m_Shared = _rhs.m_Shared;
+    ++m_Shared->refs;
+  }
+
+  m_RootNode = root;
+  return *this;
+}
+
+/*!*****************************************************************************
+ * @brief Returns a new version with a value added, leaving this one unchanged.
+ *
+ * Only the O(log n) nodes on the search path are copied. Duplicate values are
+ * ignored, in which case the new version is a snapshot of this one.
+ *
+ * @param _value The value to be inserted.
+ * @return The new version.
+ *******************************************************************************/
+template <typename T>
+PersistentAVLTree<T> PersistentAVLTree<T>::inserted(const T &_value) const
+{
+  PNode root = InsertNode(m_RootNode, _value);
+  if (root == nullptr) // Already there, nothing changes
+    root = Retain(m_RootNode);
+  return PersistentAVLTree(m_Shared, root);
+}
+
+/*!*****************************************************************************
+ * @brief Returns a new version with a value removed, leaving this one unchanged.
+ *
+ * If the value is not in the tree, the new version is a snapshot of this one.
+ *
+ * @param _value The value to be removed.
+ * @return The new version.
+ *******************************************************************************/
+template <typename T>
+PersistentAVLTree<T> PersistentAVLTree<T>::removed(const T &_value) const
+{
+  bool removed = false;
+  PNode root = RemoveNode(m_RootNode, _value, removed);
+  if (!removed) // Not there, nothing changes
+    root = Retain(m_RootNode);
+  return PersistentAVLTree(m_Shared, root);
+}
+
+/*!*****************************************************************************
+ * @brief Inserts a value into this version.
+ *
+ * Snapshots taken earlier keep the old contents. If no snapshot shares the
+ * old path, its nodes are freed once the new path is built.
+ *
+ * @param _value The value to be inserted.
+ *******************************************************************************/
+template <typename T>
+void PersistentAVLTree<T>::insert(const T &_value)
+{
+  PNode root = InsertNode(m_RootNode, _value);
+  if (root == nullptr) // Duplicate values are ignored
+    return;
+
+  Release(m_RootNode);
+  m_RootNode = root;
+}
+
+/*!*****************************************************************************
+ * @brief Removes a value from this version.
+ *
+ * Snapshots taken earlier keep the old contents.
+ *
+ * @param _value The value to be removed.
+ *******************************************************************************/
+template <typename T>
+void PersistentAVLTree<T>::remove(const T &_value)
+{
+  bool removed = false;
+  PNode root = RemoveNode(m_RootNode, _value, removed);
+  if (!removed) // Not found, nothing to do
+    return;
+
+  Release(m_RootNode);
+  m_RootNode = root;
+}
+
+/*!*****************************************************************************
+ * @brief Empties this version, freeing the nodes no other version uses.
+ *******************************************************************************/
+template <typename T>
+void PersistentAVLTree<T>::clear()
+{
+  Release(m_RootNode);
+  m_RootNode = nullptr;
+}
+
+/*!*****************************************************************************
+ * @brief Searches for a value, tracking the number of comparisons.
+ *
+ * Like BSTree::find, one compare is counted for each node visited.
+ *
+ * @param _value The value to search for in the tree.
+ * @param _compares A reference to an unsigned variable where the function will
+ *                  add the number of comparisons made during the search.
+ * @return True if the value is found in the tree, false otherwise.
+ *******************************************************************************/
+template <typename T>
+bool PersistentAVLTree<T>::find(const T &_value, unsigned &_compares) const
+{
+  PNode node = m_RootNode;
+  while (node)
+  {
+    ++_compares;
+    if (_value < node->data)
+      node = node->left;
+    else if (node->data < _value)
+      node = node->right;
+    else
+      return true;
+  }
+
+  return false;
+}
+
+/*!*****************************************************************************
+ * @brief Accesses the value at the specified index in sorted order.
+ *
+ * @param _index The zero-based index of the value to access.
+ * @return A const pointer to the value at the specified index, or nullptr if
+ *         the index is out of bounds.
+ *******************************************************************************/
+template <typename T>
+const T *PersistentAVLTree<T>::operator[](int _index) const
+{
+  if (static_cast<unsigned>(_index) >= Count(m_RootNode))
+    return nullptr; // Return nullptr if the index is invalid
+
+  unsigned index = static_cast<unsigned>(_index);
+  PNode node = m_RootNode;
+  while (node)
+  {
+    unsigned before = Count(node->left); // Values smaller than this node
+    if (index < before)
+      node = node->left;
+    else if (index == before)
+      return &node->data;
+    else
+    {
+      index -= before + 1; // Skip the left subtree and this node
+      node = node->right;
+    }
+  }
+
+  return nullptr;
+}
+
+/*!*****************************************************************************
+ * @brief Checks if this version is empty.
+ *
+ * @return True if the tree has no values, false otherwise.
+ *******************************************************************************/
+template <typename T>
+bool PersistentAVLTree<T>::empty() const
+{
+  return m_RootNode == nullptr;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of values in this version.
+ *
+ * @return The number of values in the tree.
+ *******************************************************************************/
+template <typename T>
+unsigned int PersistentAVLTree<T>::size() const
+{
+  return Count(m_RootNode);
+}
+
+/*!*****************************************************************************
+ * @brief Returns the height of this version.
+ *
+ * @return The height of the tree, -1 when empty.
+ *******************************************************************************/
+template <typename T>
+int PersistentAVLTree<T>::height() const
+{
+  return Height(m_RootNode);
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of nodes alive across all versions.
+ *
+ * Every version made from the same tree reports the same number. Comparing it
+ * with the sizes of the versions shows how many nodes they share.
+ *
+ * @return The number of nodes allocated and not yet freed.
+ *******************************************************************************/
+template <typename T>
+size_t PersistentAVLTree<T>::nodes_in_use() const
+{
+  return m_Shared->nodes;
+}
+
+/*!*****************************************************************************
+ * @brief Allocates and constructs a node over two subtrees.
+ *
+ * The node takes over the references to its children. If the allocation fails,
+ * those references are released before the exception is thrown, so the caller
+ * never has to clean up after a failed call.
+ *
+ * @param _value The value for the node.
+ * @param _left The left subtree.
+ * @param _right The right subtree.
+ * @return A pointer to the new node, with a reference count of 1.
+ *******************************************************************************/
+template <typename T>
+typename PersistentAVLTree<T>::PNode
+PersistentAVLTree<T>::MakeNode(const T &_value, PNode _left, PNode _right) const
+{
+  PNode memory;
+  try
+  {
+    memory = reinterpret_cast<PNode>(m_Shared->oa->Allocate());
+  }
+  catch (const OAException &except)
+  {
+    Release(_left);
+    Release(_right);
+    throw BSTException(BSTException::E_NO_MEMORY, except.what());
+  }
+
+  PNode node = new (memory) PersistentNode(_value, _left, _right); // Construct the node in place
+  node->count = Count(_left) + Count(_right) + 1;
+  node->height = std::max(Height(_left), Height(_right)) + 1;
+  ++m_Shared->nodes;
+  return node;
+}
+
+/*!*****************************************************************************
+ * @brief Adds a reference to a node.
+ *
+ * @param _node The node, may be nullptr.
+ * @return The same node.
+ *******************************************************************************/
+template <typename T>
+typename PersistentAVLTree<T>::PNode PersistentAVLTree<T>::Retain(PNode _node)
+{
+  if (_node)
+    ++_node->refs;
+  return _node;
+}
+
+/*!*****************************************************************************
+ * @brief Drops a reference to a node, freeing it when it was the last one.
+ *
+ * A freed node drops its references to its children in turn, so a whole
+ * subtree is freed when nothing else points into it.
+ *
+ * @param _node The node, may be nullptr.
+ *******************************************************************************/
+template <typename T>
+void PersistentAVLTree<T>::Release(PNode _node) const
+{
+  if (_node == nullptr || --_node->refs > 0)
+    return;
+
+  Release(_node->left);
+  Release(_node->right);
+  _node->~PersistentNode();
+  m_Shared->oa->Free(_node);
+  --m_Shared->nodes;
+}
+
+/*!*****************************************************************************
+ * @brief Drops this version's reference to the shared state.
+ *
+ * The last version deletes the allocator if the tree created it.
+ *******************************************************************************/
+template <typename T>
+void PersistentAVLTree<T>::ReleaseShared()
+{
+  if (--m_Shared->refs == 0)
+  {
+    if (m_Shared->freeOA)
+      delete m_Shared->oa;
+    delete m_Shared;
+  }
+  m_Shared = nullptr;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the height of a subtree, -1 for an empty one.
+ *
+ * @param _node The root of the subtree.
+ * @return The height.
+ *******************************************************************************/
+template <typename T>
+int PersistentAVLTree<T>::Height(PNode _node)
+{
+  return _node ? _node->height : -1;
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of nodes in a subtree.
+ *
+ * @param _node The root of the subtree.
+ * @return The number of nodes.
+ *******************************************************************************/
+template <typename T>
+unsigned PersistentAVLTree<T>::Count(PNode _node)
+{
+  return _node ? _node->count : 0;
+}
+
+/*!*****************************************************************************
+ * @brief Builds the new version of a subtree with a value added.
+ *
+ * The nodes on the search path are copied and every other subtree is shared
+ * with the old version.
+ *
+ * @param _node The root of the old subtree.
+ * @param _value The value to be inserted.
+ * @return The root of the new subtree, or nullptr if the value is already there.
+ *******************************************************************************/
+template <typename T>
+typename PersistentAVLTree<T>::PNode
+PersistentAVLTree<T>::InsertNode(PNode _node, const T &_value) const
+{
+  if (_node == nullptr) // Found the spot for the new value
+    return MakeNode(_value, nullptr, nullptr);
+
+  if (_value < _node->data)
+  {
+    PNode left = InsertNode(_node->left, _value);
+    if (left == nullptr) // Duplicate, nothing was built
+      return nullptr;
+    return Balance(_node->data, left, Retain(_node->right));
+  }
+  else if (_node->data < _value)
+  {
+    PNode right = InsertNode(_node->right, _value);
+    if (right == nullptr) // Duplicate, nothing was built
+      return nullptr;
+    return Balance(_node->data, Retain(_node->left), right);
+  }
+
+  return nullptr; // Duplicate
+}
+
+/*!*****************************************************************************
+ * @brief Builds the new version of a subtree with a value removed.
+ *
+ * A node with two children is replaced by a copy of its successor.
+ *
+ * @param _node The root of the old subtree.
+ * @param _value The value to be removed.
+ * @param _removed Set to true if the value was found.
+ * @return The root of the new subtree, which is only valid if _removed is true.
+ *******************************************************************************/
+template <typename T>
+typename PersistentAVLTree<T>::PNode
+PersistentAVLTree<T>::RemoveNode(PNode _node, const T &_value, bool &_removed) const
+{
+  if (_node == nullptr) // Not found
+    return nullptr;
+
+  if (_value < _node->data)
+  {
+    PNode left = RemoveNode(_node->left, _value, _removed);
+    if (!_removed)
+      return nullptr;
+    return Balance(_node->data, left, Retain(_node->right));
+  }
+  else if (_node->data < _value)
+  {
+    PNode right = RemoveNode(_node->right, _value, _removed);
+    if (!_removed)
+      return nullptr;
+    return Balance(_node->data, Retain(_node->left), right);
+  }
+
+  _removed = true;
+  if (_node->left == nullptr) // The right subtree takes its place as it is
+    return Retain(_node->right);
+  if (_node->right == nullptr) // The left subtree takes its place as it is
+    return Retain(_node->left);
+
+  PNode successor;
+  PNode right = RemoveMin(_node->right, successor);
+  return Balance(successor->data, Retain(_node->left), right);
+}
+
+/*!*****************************************************************************
+ * @brief Builds the new version of a subtree without its smallest value.
+ *
+ * @param _node The root of the old subtree, not empty.
+ * @param _min Set to the old node holding the smallest value.
+ * @return The root of the new subtree.
+ *******************************************************************************/
+template <typename T>
+typename PersistentAVLTree<T>::PNode
+PersistentAVLTree<T>::RemoveMin(PNode _node, PNode &_min) const
+{
+  if (_node->left == nullptr)
+  {
+    _min = _node;
+    return Retain(_node->right);
+  }
+
+  PNode left = RemoveMin(_node->left, _min);
+  return Balance(_node->data, left, Retain(_node->right));
+}
+
+/*!*****************************************************************************
+ * @brief Builds a balanced node over two subtrees.
+ *
+ * The heights of the subtrees differ by at most two. When they differ by two,
+ * the taller child (and its inner child for a double rotation) are copied into
+ * their rotated positions instead of being relinked, because other versions
+ * may still point to them.
+ *
+ * @param _value The value for the node.
+ * @param _left The left subtree, whose reference is taken over.
+ * @param _right The right subtree, whose reference is taken over.
+ * @return The root of the balanced subtree.
+ *******************************************************************************/
+template <typename T>
+typename PersistentAVLTree<T>::PNode
+PersistentAVLTree<T>::Balance(const T &_value, PNode _left, PNode _right) const
+{
+  int difference = Height(_left) - Height(_right);
+  PNode root;
+  PNode pending = nullptr; // Built but not linked to a parent yet
+
+  if (difference > 1) // Left-heavy
+  {
+    try
+    {
+      if (Height(_left->left) >= Height(_left->right)) // Single right rotation
+      {
+        pending = MakeNode(_value, Retain(_left->right), _right);
+        PNode right = pending;
+        pending = nullptr;
+        root = MakeNode(_left->data, Retain(_left->left), right);
+      }
+      else // Left-right double rotation
+      {
+        PNode middle = _left->right;
+        pending = MakeNode(_value, Retain(middle->right), _right);
+        PNode left = MakeNode(_left->data, Retain(_left->left), Retain(middle->left));
+        PNode right = pending;
+        pending = nullptr;
+        root = MakeNode(middle->data, left, right);
+      }
+    }
+    catch (const BSTException &)
+    {
+      Release(pending);
+      Release(_left);
+      throw;
+    }
+    Release(_left); // Its copies replaced it
+    return root;
+  }
+  else if (difference < -1) // Right-heavy
+  {
+    try
+    {
+      if (Height(_right->right) >= Height(_right->left)) // Single left rotation
+      {
+        pending = MakeNode(_value, _left, Retain(_right->left));
+        PNode left = pending;
+        pending = nullptr;
+        root = MakeNode(_right->data, left, Retain(_right->right));
+      }
+      else // Right-left double rotation
+      {
+        PNode middle = _right->left;
+        pending = MakeNode(_value, _left, Retain(middle->left));
+        PNode right = MakeNode(_right->data, Retain(middle->right), Retain(_right->right));
+        PNode left = pending;
+        pending = nullptr;
+        root = MakeNode(middle->data, left, right);
+      }
+    }
+    catch (const BSTException &)
+    {
+      Release(pending);
+      Release(_right);
+      throw;
+    }
+    Release(_right); // Its copies replaced it
+    return root;
+  }
+
+  return MakeNode(_value, _left, _right);
+}
@@ -0,0 +1,110 @@
+/*!*************************************************************************
+\file PersistentAVLTree.h
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the declaration for the PersistentAVLTree, an AVL tree
+whose versions share every subtree that an update did not touch
+***************************************************************************/
+//---------------------------------------------------------------------------
+#ifndef PERSISTENTAVLTREE_H
+#define PERSISTENTAVLTREE_H
+//---------------------------------------------------------------------------
+#include <cstddef>   // size_t
+#include <algorithm> // std::max
+#include "BSTree.h"  // BSTException, ObjectAllocator
+
+/*!
+  Definition for the persistent AVL tree.
+
+  Nodes are never changed once they are built. insert and remove copy only
+  the nodes on the search path (and the few that a rotation touches) and
+  point the copies at the untouched subtrees of the old version, so an
+  update allocates O(log n) nodes and the old version stays valid. Every
+  node counts the versions and parent nodes that point to it and is given
+  back to the ObjectAllocator when the last of them goes away.
+
+  Copying or assigning a tree is O(1): the copy is a snapshot that shares
+  the root. inserted and removed leave the tree alone and return the new
+  version instead. All versions made from one tree share its allocator,
+  which is deleted with the last of them if the tree created it. Versions
+  can be kept and read freely, but they are not safe to use from several
+  threads at once since the reference counts are not atomic.
+
+  The interface matches AVLTree, except that operator[] returns the value
+  itself.
+*/
+template <typename T>
+class PersistentAVLTree
+{
+  public:
+    //! The node structure
+    struct PersistentNode
+    {
+      T data;                //!< The data
+      PersistentNode *left;  //!< The left child
+      PersistentNode *right; //!< The right child
+      unsigned count;        //!< Nodes in this subtree for efficient indexing
+      int height;            //!< Edges to the deepest leaf, 0 for a leaf
+      unsigned refs;         //!< Versions and parents pointing to this node
+
+      //! Constructor
+      PersistentNode(const T& value, PersistentNode *l, PersistentNode *r)
+        : data(value), left(l), right(r), count(1), height(0), refs(1) {};
+    };
+
+    //! shorthand
+    typedef PersistentNode* PNode;
+
+    PersistentAVLTree(ObjectAllocator *oa = 0);
+    PersistentAVLTree(const PersistentAVLTree& rhs);
+    ~PersistentAVLTree();
+    PersistentAVLTree& operator=(const PersistentAVLTree& rhs);
+    PersistentAVLTree inserted(const T& value) const;
+    PersistentAVLTree removed(const T& value) const;
+    void insert(const T& value);
+    void remove(const T& value);
+    void clear();
+    bool find(const T& value, unsigned &compares) const;
+    const T* operator[](int index) const;
+    bool empty() const;
+    unsigned int size() const;
+    int height() const;
+    size_t nodes_in_use() const;
+
+  private:
+    //! State shared by every version made from the same tree
+    struct Shared
+    {
+      ObjectAllocator *oa; //!< Allocator for the nodes
+      bool freeOA;         //!< Whether the allocator is deleted with the last version
+      unsigned refs;       //!< Versions using this state
+      size_t nodes;        //!< Nodes alive across all versions
+    };
+
+    PersistentAVLTree(Shared *_shared, PNode _root);
+
+    PNode MakeNode(const T& _value, PNode _left, PNode _right) const;
+    static PNode Retain(PNode _node);
+    void Release(PNode _node) const;
+    void ReleaseShared();
+
+    static int Height(PNode _node);
+    static unsigned Count(PNode _node);
+
+    PNode InsertNode(PNode _node, const T& _value) const;
+    PNode RemoveNode(PNode _node, const T& _value, bool& _removed) const;
+    PNode RemoveMin(PNode _node, PNode& _min) const;
+    PNode Balance(const T& _value, PNode _left, PNode _right) const;
+
+    Shared *m_Shared; //!< Allocator and counters, shared with the other versions
+    PNode m_RootNode; //!< The root, nullptr when empty
+};
+
+#include "PersistentAVLTree.cpp"
+
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,379 @@
+/*!*************************************************************************
+\file RBTree.cpp
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the implementation for the RBTree
+***************************************************************************/
+#include "RBTree.h"
+
+/*!*****************************************************************************
+ * @brief Constructs an RBTree with an optional ObjectAllocator.
+ *
+ * @param _OA Pointer to an external ObjectAllocator, or nullptr to use default allocation.
+ * @param _shareOA Flag indicating whether the provided allocator is shared with other data structures.
+ *******************************************************************************/
+template <typename T>
+RBTree<T>::RBTree(ObjectAllocator *_OA, bool _shareOA)
+    : BSTree<T>{_OA, _shareOA}, m_Rotations{0}
+{
+}
+
+/*!*****************************************************************************
+ * @brief Inserts a new value into the red-black tree.
+ *
+ * The value is added as a red leaf. The slots (the child pointers) on the way
+ * down are kept in a path, since the nodes have no parent pointers, and the
+ * path is then used to repair any red node that ended up with a red parent.
+ * Duplicate values are ignored.
+ *
+ * @param _value The value to be inserted into the tree.
+ *******************************************************************************/
+template <typename T>
+void RBTree<T>::insert(const T &_value)
+{
+    Path path;
+    BinTree *slot = &this->get_root(); // Slot where the walk currently is
+
+    while (*slot) // Walk down to the empty slot for the value
+    {
+        path.push_back(slot);
+        if (_value < (*slot)->data)
+            slot = &(*slot)->left;
+        else if ((*slot)->data < _value)
+            slot = &(*slot)->right;
+        else
+            return; // Already in the tree
+    }
+
+    *slot = this->make_node(_value); // New nodes are red
+    ++this->m_Size;
+    path.push_back(slot);
+
+    for (size_t i = path.size() - 1; i-- > 0;) // Every ancestor gained a node
+        this->update_node(*path[i]);
+
+    FixInsert(path);
+}
+
+/*!*****************************************************************************
+ * @brief Removes a value from the red-black tree.
+ *
+ * A node with two children takes the value of its predecessor, which is removed
+ * instead, so the node that is unlinked always has at most one child. Removing
+ * a black node leaves its subtree one black node short, which is repaired along
+ * the path. The cached counts and heights on the path are refreshed at the end.
+ *
+ * @param _value The value to be removed from the tree.
+ *******************************************************************************/
+template <typename T>
+void RBTree<T>::remove(const T &_value)
+{
+    Path path;
+    BinTree *slot = &this->get_root(); // Slot where the walk currently is
+
+    while (*slot) // Walk down to the node holding the value
+    {
+        if (_value < (*slot)->data)
+        {
+            path.push_back(slot);
+            slot = &(*slot)->left;
+        }
+        else if ((*slot)->data < _value)
+        {
+            path.push_back(slot);
+            slot = &(*slot)->right;
+        }
+        else
+            break;
+    }
+
+    if (*slot == nullptr) // Not in the tree
+        return;
+
+    if ((*slot)->left && (*slot)->right) // Two children, remove the predecessor instead
+    {
+        BinTree node = *slot;
+        path.push_back(slot);
+        slot = &node->left;
+        while ((*slot)->right)
+        {
+            path.push_back(slot);
+            slot = &(*slot)->right;
+        }
+        node->data = (*slot)->data;
+    }
+
+    BinTree removed = *slot;
+    BinTree child = removed->left ? removed->left : removed->right; // At most one child
+    bool wasBlack = !IsRed(removed);
+    *slot = child; // Unlink the node
+    this->free_node(removed);
+    --this->m_Size;
+    path.push_back(slot);
+
+    if (wasBlack)
+    {
+        if (IsRed(child)) // The child can take over the missing black
+            child->balance_factor = BLACK;
+        else
+            FixRemove(path);
+    }
+
+    for (size_t i = path.size(); i-- > 0;) // Refresh the cached metrics bottom-up
+    {
+        if (*path[i])
+            this->update_node(*path[i]);
+    }
+}
+
+/*!*****************************************************************************
+ * @brief Recolors the tree after clear, build_from_sorted or bulk_insert.
+ *
+ * Those leave a complete tree. Coloring the nodes on the last level red and
+ * every other node black then gives every path the same number of black nodes.
+ *******************************************************************************/
+template <typename T>
+void RBTree<T>::rebuilt()
+{
+    ColorByDepth(this->get_root(), 0, this->height());
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of rotations done by this tree.
+ *
+ * @return The number of rotations since the tree was constructed.
+ *******************************************************************************/
+template <typename T>
+unsigned long long RBTree<T>::rotations() const
+{
+    return m_Rotations;
+}
+
+/*!*****************************************************************************
+ * @brief Repairs a red node with a red parent after an insert.
+ *
+ * While the node's uncle is red, the parent and uncle turn black and the
+ * grandparent turns red, which moves the problem two levels up. Otherwise one
+ * or two rotations at the grandparent fix it for good. The counts and heights
+ * are already correct below the rotation, so only the slots above it are
+ * refreshed.
+ *
+ * @param _path The slots from the root down to the new node.
+ *******************************************************************************/
+template <typename T>
+void RBTree<T>::FixInsert(Path &_path)
+{
+    size_t node = _path.size() - 1; // Index of the slot of the red node
+    size_t top = _path.size();      // Slots above this index need refreshing
+
+    while (node >= 2 && IsRed(*_path[node - 1])) // A red parent is never the root
+    {
+        BinTree parent = *_path[node - 1];
+        BinTree grand = *_path[node - 2];
+        bool parentIsLeft = (grand->left == parent);
+        BinTree uncle = parentIsLeft ? grand->right : grand->left;
+
+        if (IsRed(uncle)) // Recolor and continue from the grandparent
+        {
+            parent->balance_factor = BLACK;
+            uncle->balance_factor = BLACK;
+            grand->balance_factor = RED;
+            node -= 2;
+            continue;
+        }
+
+        if (parentIsLeft)
+        {
+            if (parent->right == *_path[node]) // Inner child, make it outer first
+                LeftRotation(*_path[node - 1]);
+            RightRotation(*_path[node - 2]);
+        }
+        else
+        {
+            if (parent->left == *_path[node]) // Inner child, make it outer first
+                RightRotation(*_path[node - 1]);
+            LeftRotation(*_path[node - 2]);
+        }
+
+        (*_path[node - 2])->balance_factor = BLACK; // The new subtree root
+        grand->balance_factor = RED;                // Now one of its children
+        top = node - 2;
+        break;
+    }
+
+    this->get_root()->balance_factor = BLACK; // The root is always black
+
+    for (size_t i = top; i-- > 0;) // The rotated subtree may have a new height
+        this->update_node(*_path[i]);
+}
+
+/*!*****************************************************************************
+ * @brief Repairs a subtree that is one black node short after a remove.
+ *
+ * The short subtree is at the last slot of the path. Depending on the colors of
+ * its sibling and the sibling's children, the sibling is recolored (moving the
+ * problem up to the parent) or the parent is rotated (ending it). Rotations on
+ * the path insert the slot of the node that moved down, so the path still leads
+ * from the root down to the short subtree for the final refresh.
+ *
+ * @param _path The slots from the root down to the short subtree.
+ *******************************************************************************/
+template <typename T>
+void RBTree<T>::FixRemove(Path &_path)
+{
+    size_t node = _path.size() - 1; // Index of the slot of the short subtree
+
+    while (node > 0 && !IsRed(*_path[node]))
+    {
+        BinTree parent = *_path[node - 1];
+
+        if (_path[node] == &parent->left)
+        {
+            BinTree sibling = parent->right;
+            if (IsRed(sibling)) // Make the sibling black by rotating it above the parent
+            {
+                sibling->balance_factor = BLACK;
+                parent->balance_factor = RED;
+                LeftRotation(*_path[node - 1]);
+                _path.insert(_path.begin() + node, &sibling->left);
+                ++node;
+                sibling = parent->right;
+            }
+
+            if (!IsRed(sibling->left) && !IsRed(sibling->right)) // Take a black from both sides
+            {
+                sibling->balance_factor = RED;
+                --node; // The parent is now short
+                continue;
+            }
+
+            if (!IsRed(sibling->right)) // Move the red child to the outside
+            {
+                sibling->left->balance_factor = BLACK;
+                sibling->balance_factor = RED;
+                RightRotation(parent->right);
+                sibling = parent->right;
+            }
+
+            sibling->balance_factor = parent->balance_factor; // The sibling takes the parent's place
+            parent->balance_factor = BLACK;
+            sibling->right->balance_factor = BLACK;
+            LeftRotation(*_path[node - 1]);
+            _path.insert(_path.begin() + node, &sibling->left);
+        }
+        else // Mirror image
+        {
+            BinTree sibling = parent->left;
+            if (IsRed(sibling))
+            {
+                sibling->balance_factor = BLACK;
+                parent->balance_factor = RED;
+                RightRotation(*_path[node - 1]);
+                _path.insert(_path.begin() + node, &sibling->right);
+                ++node;
+                sibling = parent->left;
+            }
+
+            if (!IsRed(sibling->left) && !IsRed(sibling->right))
+            {
+                sibling->balance_factor = RED;
+                --node;
+                continue;
+            }
+
+            if (!IsRed(sibling->left))
+            {
+                sibling->right->balance_factor = BLACK;
+                sibling->balance_factor = RED;
+                LeftRotation(parent->left);
+                sibling = parent->left;
+            }
+
+            sibling->balance_factor = parent->balance_factor;
+            parent->balance_factor = BLACK;
+            sibling->left->balance_factor = BLACK;
+            RightRotation(*_path[node - 1]);
+            _path.insert(_path.begin() + node, &sibling->right);
+        }
+        break; // The rotation restored the black count
+    }
+
+    if (*_path[node]) // A red node absorbs the missing black
+        (*_path[node])->balance_factor = BLACK;
+    if (this->get_root())
+        this->get_root()->balance_factor = BLACK;
+}
+
+/*!*****************************************************************************
+ * @brief Colors a complete tree so that it is a valid red-black tree.
+ *
+ * @param _tree The root of the subtree to color.
+ * @param _depth The depth of _tree.
+ * @param _redDepth The depth of the last level, which is colored red (except a lone root).
+ *******************************************************************************/
+template <typename T>
+void RBTree<T>::ColorByDepth(BinTree _tree, int _depth, int _redDepth)
+{
+    if (_tree == nullptr)
+        return;
+
+    _tree->balance_factor = (_depth == _redDepth && _depth > 0) ? RED : BLACK;
+    ColorByDepth(_tree->left, _depth + 1, _redDepth);
+    ColorByDepth(_tree->right, _depth + 1, _redDepth);
+}
+
+/*!*****************************************************************************
+ * @brief Checks the color of a node, empty subtrees count as black.
+ *
+ * @param _tree The node to check.
+ * @return True if the node exists and is red.
+ *******************************************************************************/
+template <typename T>
+bool RBTree<T>::IsRed(BinTree _tree)
+{
+    return _tree && _tree->balance_factor == RED;
+}
+
+/*!*****************************************************************************
+ * @brief Performs a left rotation on the given subtree.
+ *
+ * The colors are left alone, the caller recolors. The cached count and height of
+ * the two nodes that moved are refreshed.
+ *
+ * @param _tree Reference to the root of the subtree to be rotated.
+ *******************************************************************************/
+template <typename T>
+void RBTree<T>::LeftRotation(BinTree &_tree)
+{
+    BinTree newRoot = _tree->right; // The right child becomes the new root of the rotated subtree
+    _tree->right = newRoot->left;   // Its left subtree moves under the old root
+    newRoot->left = _tree;          // The old root becomes the left child of the new root
+    this->update_node(_tree);       // The old root is now below the new root, so refresh it first
+    this->update_node(newRoot);     // Then refresh the new root
+    _tree = newRoot;
+    ++m_Rotations; // Count it for rotations()
+}
+
+/*!*****************************************************************************
+ * @brief Performs a right rotation on the given subtree.
+ *
+ * The colors are left alone, the caller recolors. The cached count and height of
+ * the two nodes that moved are refreshed.
+ *
+ * @param _tree Reference to the root of the subtree to be rotated.
+ *******************************************************************************/
+template <typename T>
+void RBTree<T>::RightRotation(BinTree &_tree)
+{
+    BinTree newRoot = _tree->left; // The left child becomes the new root of the rotated subtree
+    _tree->left = newRoot->right;  // Its right subtree moves under the old root
+    newRoot->right = _tree;        // The old root becomes the right child of the new root
+    this->update_node(_tree);      // The old root is now below the new root, so refresh it first
+    this->update_node(newRoot);    // Then refresh the new root
+    _tree = newRoot;
+    ++m_Rotations; // Count it for rotations()
+}
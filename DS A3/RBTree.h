@@ -0,0 +1,59 @@
+/*!*************************************************************************
+\file RBTree.h
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the declaration for the RBTree
+***************************************************************************/
+//---------------------------------------------------------------------------
+#ifndef RBTREE_H
+#define RBTREE_H
+//---------------------------------------------------------------------------
+#include <vector>
+#include "BSTree.h"
+
+/*!
+  Definition for the Red-Black Tree
+
+  The color of each node is kept in its balance_factor. The balance is looser
+  than AVL (the height is at most 2 log(n + 1)), so inserts need at most two
+  rotations and removes at most three.
+*/
+template <typename T>
+class RBTree : public BSTree<T>
+{
+  public:
+    RBTree(ObjectAllocator *oa = 0, bool ShareOA = false);
+    virtual ~RBTree() = default;
+    virtual void insert(const T& value) override;
+    virtual void remove(const T& value) override;
+    unsigned long long rotations() const;
+
+  protected:
+    virtual void rebuilt() override;
+
+  private:
+    using BinTree = typename BSTree<T>::BinTree;
+    using Path = std::vector<BinTree *>;
+
+    //! The colors stored in balance_factor, new nodes start out red
+    enum Color { RED = 0, BLACK = 1 };
+
+    void FixInsert(Path& path);
+    void FixRemove(Path& path);
+    void ColorByDepth(BinTree tree, int depth, int redDepth);
+    static bool IsRed(BinTree tree);
+
+    void LeftRotation(BinTree& tree);
+    void RightRotation(BinTree& tree);
+
+    unsigned long long m_Rotations; //!< Rotations done since construction
+};
+
+#include "RBTree.cpp"
+
+#endif
+//---------------------------------------------------------------------------
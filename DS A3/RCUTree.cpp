@@ -0,0 +1,532 @@
+/*!*************************************************************************
+\file RCUTree.cpp
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the implementation for the RCUTree
+***************************************************************************/
+#include "RCUTree.h"
+
+/*!*****************************************************************************
+ * @brief Constructs an RCUTree with an optional ObjectAllocator.
+ *
+ * The allocator is only ever used by the writer side, so it does not need to
+ * be thread-safe.
+ *
+ * @param _OA Pointer to an external ObjectAllocator, or nullptr to use default allocation.
+ * @param _shareOA Flag indicating whether the provided allocator is shared with other data structures.
+ *******************************************************************************/
+template <typename T>
+RCUTree<T>::RCUTree(ObjectAllocator *_OA, bool _shareOA)
+    : BSTree<T>{_OA, _shareOA}, m_Published{nullptr}, m_Epoch{0}
+{
+}
+
+/*!*****************************************************************************
+ * @brief Destroys the RCUTree.
+ *
+ * No reader may still be running. Nodes that are waiting for a grace period are
+ * freed here, and the base class frees the nodes of the current tree.
+ *******************************************************************************/
+template <typename T>
+RCUTree<T>::~RCUTree()
+{
+  Reclaim();
+}
+
+/*!*****************************************************************************
+ * @brief Inserts a new value into the RCUTree.
+ *
+ * The search path is copied, the copies are rebalanced and the new root is
+ * published. Readers keep using the old path until they finish, after which
+ * the replaced nodes are freed. If the insertion fails for any reason, the
+ * published tree is left untouched and the exception is rethrown.
+ *
+ * @param _value The value to be inserted into the tree.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::insert(const T &_value)
+{
+  std::lock_guard<std::mutex> lock(m_WriteLock); // One writer at a time
+  unsigned int size = this->m_Size;              // Restored if the insertion fails
+
+  try
+  {
+    Publish(InsertRCU(this->m_RootNode, _value));
+  }
+  catch (...)
+  {
+    Abandon(size); // Drop the partial copy; readers never saw it
+    throw; // For rethrowing the current exception without losing its original context
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Removes a value from the RCUTree, if it exists.
+ *
+ * The search path is copied without the removed node, the copies are
+ * rebalanced and the new root is published. The removed node and the replaced
+ * path are freed once no reader can still see them.
+ *
+ * @param _value The value to be removed from the tree.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::remove(const T &_value)
+{
+  std::lock_guard<std::mutex> lock(m_WriteLock); // One writer at a time
+  unsigned int size = this->m_Size;              // Restored if the removal fails
+
+  try
+  {
+    Publish(RemoveRCU(this->m_RootNode, _value));
+  }
+  catch (...)
+  {
+    Abandon(size); // Drop the partial copy; readers never saw it
+    throw; // For rethrowing the current exception without losing its original context
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Searches for a value in the RCUTree, tracking the number of comparisons.
+ *
+ * This function may be called from any number of threads, also while another
+ * thread inserts or removes. It never blocks: it announces itself in a reader
+ * slot, walks the currently published tree and leaves the slot again. The
+ * compares are counted exactly like BSTree::find.
+ *
+ * @param _value The value to search for in the tree.
+ * @param _compares A reference to an unsigned variable where the function will
+ *                  add the number of comparisons made during the search.
+ * @return True if the value is found in the tree, false otherwise.
+ *******************************************************************************/
+template <typename T>
+bool RCUTree<T>::find(const T &_value, unsigned &_compares) const
+{
+  unsigned parity = ReadLock(); // Enter the read-side section
+
+  BinTree node = m_Published.load(); // The tree as of now; it stays valid until ReadUnlock
+  bool found = false;
+  for (;;)
+  {
+    ++_compares; // Increment the comparison counter
+
+    if (node == nullptr) // The value is not in the tree
+      break;
+
+    if (_value == node->data) // The value matches the current node's data
+    {
+      found = true;
+      break;
+    }
+
+    // Continue in the subtree that may hold the value
+    node = (_value < node->data) ? node->left : node->right;
+  }
+
+  ReadUnlock(parity); // Leave the read-side section
+  return found;
+}
+
+/*!*****************************************************************************
+ * @brief Enters a read-side section.
+ *
+ * The reader counts itself in its slot under the parity of the current epoch.
+ * If the writer flipped the epoch in the meantime, the reader moves over to the
+ * new parity, so the writer never waits for a reader that started too late.
+ *
+ * @return The parity the reader was counted under, needed by ReadUnlock.
+ *******************************************************************************/
+template <typename T>
+unsigned RCUTree<T>::ReadLock() const
+{
+  ReaderSlot &slot = m_Readers[ReaderSlotIndex()];
+
+  for (;;)
+  {
+    unsigned epoch = m_Epoch.load();
+    unsigned parity = epoch & 1;
+
+    slot.active[parity].fetch_add(1); // Announce the reader
+
+    if (m_Epoch.load() == epoch) // The writer has not flipped since, so it will wait for us
+      return parity;
+
+    slot.active[parity].fetch_sub(1); // Too late for this epoch, try again
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Leaves a read-side section.
+ *
+ * @param _parity The parity returned by the matching ReadLock.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::ReadUnlock(unsigned _parity) const
+{
+  m_Readers[ReaderSlotIndex()].active[_parity].fetch_sub(1);
+}
+
+/*!*****************************************************************************
+ * @brief Returns the reader slot of the calling thread.
+ *
+ * Threads are given slots round-robin the first time they read, so readers on
+ * different threads mostly touch different cache lines.
+ *
+ * @return The index of the calling thread's reader slot.
+ *******************************************************************************/
+template <typename T>
+unsigned RCUTree<T>::ReaderSlotIndex()
+{
+  static std::atomic<unsigned> next{0};
+  thread_local unsigned index = next.fetch_add(1) % READER_SLOTS;
+  return index;
+}
+
+/*!*****************************************************************************
+ * @brief Hides the tree from the readers before BSTree frees or relinks it.
+ *
+ * Called by clear, build_from_sorted and bulk_insert. An empty tree is
+ * published and the writer waits for the readers of the old one, so the base
+ * class may then change the nodes in place. The write lock is held until
+ * rebuilt.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::rebuilding()
+{
+  m_WriteLock.lock();         // One writer at a time, released by rebuilt
+  m_Published.store(nullptr); // New readers see an empty tree
+  Synchronize();              // Wait for the readers of the old tree
+}
+
+/*!*****************************************************************************
+ * @brief Hands the tree built by BSTree to the readers.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::rebuilt()
+{
+  Publish(this->m_RootNode); // Hand the new tree to the readers
+  m_WriteLock.unlock();
+}
+
+/*!*****************************************************************************
+ * @brief Makes a new root visible to the readers.
+ *
+ * Once published, the nodes of the new tree are shared with readers and are
+ * never modified again. If the write replaced any nodes, the writer waits for
+ * a grace period and then gives those nodes back to the allocator.
+ *
+ * @param _root The root of the new tree.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::Publish(BinTree _root)
+{
+  this->m_RootNode = _root; // The writer's own view
+  m_Published.store(_root); // The readers' view
+  m_Fresh.clear();          // The new nodes are shared from now on
+
+  if (!m_Retired.empty())
+  {
+    Synchronize(); // Wait until no reader can still see the replaced nodes
+    Reclaim();     // Then free them
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Waits for a grace period.
+ *
+ * The epoch is flipped, and then the writer waits until every reader that
+ * entered under the old parity has left. Those are the only readers that may
+ * have loaded a root from before the last publish.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::Synchronize()
+{
+  unsigned parity = m_Epoch.load() & 1;
+  m_Epoch.fetch_add(1); // New readers are counted under the other parity
+
+  for (unsigned i = 0; i < READER_SLOTS; ++i)
+  {
+    while (m_Readers[i].active[parity].load() != 0)
+      std::this_thread::yield(); // Let the reader finish
+  }
+}
+
+/*!*****************************************************************************
+ * @brief Frees the nodes that were replaced by the last write.
+ *
+ * Must only be called when no reader can reach these nodes any more.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::Reclaim()
+{
+  for (size_t i = 0; i < m_Retired.size(); ++i)
+    this->free_node(m_Retired[i]);
+  m_Retired.clear();
+}
+
+/*!*****************************************************************************
+ * @brief Drops the partial result of a failed write.
+ *
+ * The copies made by the write were never published, so they are freed right
+ * away. The nodes it meant to replace are still in use and are kept.
+ *
+ * @param _size The size of the tree before the write.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::Abandon(unsigned int _size)
+{
+  for (size_t i = 0; i < m_Fresh.size(); ++i)
+    this->free_node(m_Fresh[i]);
+  m_Fresh.clear();
+  m_Retired.clear();
+  this->m_Size = _size;
+}
+
+/*!*****************************************************************************
+ * @brief Recursively inserts a value by copying the search path.
+ *
+ * Nodes off the path are shared with the old tree. A node on the path is only
+ * copied if something below it changed, so inserting a duplicate copies nothing.
+ *
+ * @param _tree The root of the (shared) subtree to insert into.
+ * @param _value The value to be inserted.
+ * @return The root of the new subtree, or _tree itself if nothing changed.
+ *******************************************************************************/
+template <typename T>
+typename RCUTree<T>::BinTree RCUTree<T>::InsertRCU(BinTree _tree, const T &_value)
+{
+  // Base case: create the new leaf
+  if (_tree == nullptr)
+  {
+    ReserveFresh();
+    BinTree node = this->make_node(_value);
+    m_Fresh.push_back(node); // Not yet visible to readers
+    ++this->m_Size;
+    return node;
+  }
+
+  if (_value < _tree->data)
+  {
+    BinTree left = InsertRCU(_tree->left, _value);
+    if (left == _tree->left) // Nothing changed below
+      return _tree;
+
+    BinTree copy = Fresh(_tree); // Copy the node on the path
+    copy->left = left;
+    return BalanceRCU(copy);
+  }
+  else if (_value > _tree->data)
+  {
+    BinTree right = InsertRCU(_tree->right, _value);
+    if (right == _tree->right) // Nothing changed below
+      return _tree;
+
+    BinTree copy = Fresh(_tree); // Copy the node on the path
+    copy->right = right;
+    return BalanceRCU(copy);
+  }
+
+  return _tree; // Duplicate value, nothing to insert
+}
+
+/*!*****************************************************************************
+ * @brief Recursively removes a value by copying the search path.
+ *
+ * A node with two children takes the value of its predecessor, which is then
+ * removed from the left subtree, like in BSTree. Removed nodes are retired and
+ * freed after the next grace period.
+ *
+ * @param _tree The root of the (shared) subtree to remove from.
+ * @param _value The value to be removed.
+ * @return The root of the new subtree, or _tree itself if nothing changed.
+ *******************************************************************************/
+template <typename T>
+typename RCUTree<T>::BinTree RCUTree<T>::RemoveRCU(BinTree _tree, const T &_value)
+{
+  if (_tree == nullptr) // Base case: the value is not in the tree
+    return _tree;
+
+  if (_value < _tree->data)
+  {
+    BinTree left = RemoveRCU(_tree->left, _value);
+    if (left == _tree->left) // Nothing changed below
+      return _tree;
+
+    BinTree copy = Fresh(_tree); // Copy the node on the path
+    copy->left = left;
+    return BalanceRCU(copy);
+  }
+  else if (_value > _tree->data)
+  {
+    BinTree right = RemoveRCU(_tree->right, _value);
+    if (right == _tree->right) // Nothing changed below
+      return _tree;
+
+    BinTree copy = Fresh(_tree); // Copy the node on the path
+    copy->right = right;
+    return BalanceRCU(copy);
+  }
+
+  // The current node holds the value; with at most one child, the child takes its place
+  if (_tree->left == nullptr || _tree->right == nullptr)
+  {
+    BinTree child = _tree->left ? _tree->left : _tree->right;
+    Retire(_tree);
+    --this->m_Size;
+    return child;
+  }
+
+  // Two children: take over the predecessor's value and remove the predecessor instead
+  BinTree pred = nullptr;
+  this->find_predecessor(_tree, pred);
+  T value = pred->data;
+
+  BinTree left = RemoveRCU(_tree->left, value);
+  BinTree copy = Fresh(_tree); // Copy the node on the path
+  copy->data = value;
+  copy->left = left;
+  return BalanceRCU(copy);
+}
+
+/*!*****************************************************************************
+ * @brief Restores the AVL balance of a freshly copied node.
+ *
+ * The cached count and height are refreshed first. If the node is unbalanced,
+ * the nodes that take part in the rotation are copied too (if they are still
+ * shared) before they are rotated, so no published node is ever modified.
+ *
+ * @param _tree A node created by the current write.
+ * @return The root of the balanced subtree.
+ *******************************************************************************/
+template <typename T>
+typename RCUTree<T>::BinTree RCUTree<T>::BalanceRCU(BinTree _tree)
+{
+  this->update_node(_tree); // Refresh the cached count and height
+
+  int heightLeft = this->tree_height(_tree->left);
+  int heightRight = this->tree_height(_tree->right);
+
+  // Right-heavy subtree case
+  if (heightRight - heightLeft > 1)
+  {
+    _tree->right = Fresh(_tree->right);
+
+    // Check for the need for a double rotation (right-left case)
+    if (this->tree_height(_tree->right->left) > this->tree_height(_tree->right->right))
+    {
+      _tree->right->left = Fresh(_tree->right->left);
+      _tree->right = RightRotation(_tree->right);
+    }
+    return LeftRotation(_tree);
+  }
+  // Left-heavy subtree case
+  else if (heightLeft - heightRight > 1)
+  {
+    _tree->left = Fresh(_tree->left);
+
+    // Check for the need for a double rotation (left-right case)
+    if (this->tree_height(_tree->left->right) > this->tree_height(_tree->left->left))
+    {
+      _tree->left->right = Fresh(_tree->left->right);
+      _tree->left = LeftRotation(_tree->left);
+    }
+    return RightRotation(_tree);
+  }
+
+  return _tree;
+}
+
+/*!*****************************************************************************
+ * @brief Performs a left rotation on two freshly copied nodes.
+ *
+ * @param _tree The root of the subtree; it and its right child must be fresh.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename RCUTree<T>::BinTree RCUTree<T>::LeftRotation(BinTree _tree)
+{
+  BinTree newRoot = _tree->right; // The right child becomes the new root of the rotated subtree
+  _tree->right = newRoot->left;   // The left child of the new root becomes the right child of the old root
+  newRoot->left = _tree;          // The old root becomes the left child of the new root
+  this->update_node(_tree);       // The old root is now below the new root, so refresh it first
+  this->update_node(newRoot);     // Then refresh the new root
+  return newRoot;
+}
+
+/*!*****************************************************************************
+ * @brief Performs a right rotation on two freshly copied nodes.
+ *
+ * @param _tree The root of the subtree; it and its left child must be fresh.
+ * @return The new root of the subtree.
+ *******************************************************************************/
+template <typename T>
+typename RCUTree<T>::BinTree RCUTree<T>::RightRotation(BinTree _tree)
+{
+  BinTree newRoot = _tree->left; // The left child becomes the new root of the rotated subtree
+  _tree->left = newRoot->right;  // The right child of the new root becomes the left child of the old root
+  newRoot->right = _tree;        // The old root becomes the right child of the new root
+  this->update_node(_tree);      // The old root is now below the new root, so refresh it first
+  this->update_node(newRoot);    // Then refresh the new root
+  return newRoot;
+}
+
+/*!*****************************************************************************
+ * @brief Returns a node that the current write may modify.
+ *
+ * Nodes created by the current write are returned as they are. Shared nodes
+ * are copied, and the original is retired so that it is freed after the next
+ * grace period.
+ *
+ * @param _node The node that is about to be modified.
+ * @return The node itself if it is fresh, otherwise a fresh copy of it.
+ *******************************************************************************/
+template <typename T>
+typename RCUTree<T>::BinTree RCUTree<T>::Fresh(BinTree _node)
+{
+  // A write copies O(log n) nodes, so a linear scan is cheap
+  for (size_t i = 0; i < m_Fresh.size(); ++i)
+  {
+    if (m_Fresh[i] == _node)
+      return _node;
+  }
+
+  ReserveFresh();
+  BinTree copy = this->make_node(_node->data);
+  copy->left = _node->left;
+  copy->right = _node->right;
+  copy->balance_factor = _node->balance_factor;
+  copy->count = _node->count;
+  copy->height = _node->height;
+  m_Fresh.push_back(copy);
+
+  Retire(_node);
+  return copy;
+}
+
+/*!*****************************************************************************
+ * @brief Marks a node as replaced by the current write.
+ *
+ * @param _node The node that is no longer part of the new tree.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::Retire(BinTree _node)
+{
+  m_Retired.push_back(_node);
+}
+
+/*!*****************************************************************************
+ * @brief Makes room in m_Fresh for one more node.
+ *
+ * Called before the node is allocated, so that recording it afterwards cannot
+ * throw and leave a node that Abandon does not know about.
+ *******************************************************************************/
+template <typename T>
+void RCUTree<T>::ReserveFresh()
+{
+  if (m_Fresh.size() == m_Fresh.capacity())
+    m_Fresh.reserve(2 * m_Fresh.size() + 16);
+}
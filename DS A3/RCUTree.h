@@ -0,0 +1,96 @@
+/*!*************************************************************************
+\file RCUTree.h
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the declaration for the RCUTree, an AVL tree that lets
+many threads call find while another thread inserts and removes
+***************************************************************************/
+//---------------------------------------------------------------------------
+#ifndef RCUTREE_H
+#define RCUTREE_H
+//---------------------------------------------------------------------------
+#include <atomic> // std::atomic
+#include <mutex>  // std::mutex, std::lock_guard
+#include <thread> // std::this_thread::yield
+#include <vector> // std::vector
+#include "BSTree.h"
+
+/*!
+  Definition for the read-copy-update tree.
+
+  Writers never modify a node that readers can reach. insert and remove copy
+  the nodes on the search path (path copying), rebalance the copies like an
+  AVL tree and then publish the new root atomically. Readers only load the
+  published root, so they never block and never see a half-updated tree.
+  The nodes that were replaced are given back to the ObjectAllocator after a
+  grace period, once every reader that could still see them has finished.
+
+  Only find may run concurrently with insert/remove. The other BSTree methods
+  (size, height, operator[], root, ...) must be called from the writer side.
+  clear, build_from_sorted and bulk_insert show readers an empty tree while
+  they run and then publish the result.
+*/
+template <typename T>
+class RCUTree : public BSTree<T>
+{
+  public:
+    RCUTree(ObjectAllocator *oa = 0, bool ShareOA = false);
+    virtual ~RCUTree();
+    RCUTree(const RCUTree& rhs) = delete;
+    RCUTree& operator=(const RCUTree& rhs) = delete;
+    virtual void insert(const T& value) override;
+    virtual void remove(const T& value) override;
+    virtual bool find(const T& value, unsigned &compares) const override;
+
+  protected:
+    virtual void rebuilding() override;
+    virtual void rebuilt() override;
+
+  private:
+    using BinTree = typename BSTree<T>::BinTree;
+
+    //! Number of reader slots, threads are spread over them
+    static const unsigned READER_SLOTS = 64;
+
+    //! Readers inside a read-side section, one counter per epoch parity
+    struct alignas(64) ReaderSlot
+    {
+      std::atomic<unsigned> active[2]; //!< readers that entered in an even/odd epoch
+
+      //! Default constructor
+      ReaderSlot() { active[0] = 0; active[1] = 0; }
+    };
+
+    unsigned ReadLock() const;
+    void ReadUnlock(unsigned _parity) const;
+    static unsigned ReaderSlotIndex();
+    void Publish(BinTree _root);
+    void Synchronize();
+    void Reclaim();
+    void Abandon(unsigned int _size);
+
+    BinTree InsertRCU(BinTree _tree, const T& _value);
+    BinTree RemoveRCU(BinTree _tree, const T& _value);
+    BinTree BalanceRCU(BinTree _tree);
+    BinTree LeftRotation(BinTree _tree);
+    BinTree RightRotation(BinTree _tree);
+    BinTree Fresh(BinTree _node);
+    void Retire(BinTree _node);
+    void ReserveFresh();
+
+    std::atomic<BinTree> m_Published;                //!< The root readers see
+    std::atomic<unsigned> m_Epoch;                   //!< Flipped by the writer once per grace period
+    mutable ReaderSlot m_Readers[READER_SLOTS];      //!< Per-slot reader counters
+    std::mutex m_WriteLock;                          //!< Serializes writers
+    std::vector<BinTree> m_Fresh;                    //!< Nodes created by the current write
+    std::vector<BinTree> m_Retired;                  //!< Nodes replaced by the current write
+};
+
+#include "RCUTree.cpp"
+
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,233 @@
+/*!*************************************************************************
+\file Treap.cpp
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the implementation for the Treap
+***************************************************************************/
+#include "Treap.h"
+
+/*!*****************************************************************************
+ * @brief Constructs a Treap with an optional ObjectAllocator.
+ *
+ * @param _OA Pointer to an external ObjectAllocator, or nullptr to use default allocation.
+ * @param _shareOA Flag indicating whether the provided allocator is shared with other data structures.
+ * @param _seed Seed of the priorities, the same seed and operations give the same tree.
+ *******************************************************************************/
+template <typename T>
+Treap<T>::Treap(ObjectAllocator *_OA, bool _shareOA, unsigned _seed)
+    : BSTree<T>{_OA, _shareOA}, m_Seed{_seed ? _seed : 1u}, m_Rotations{0}
+{
+}
+
+/*!*****************************************************************************
+ * @brief Inserts a new value into the treap.
+ *
+ * The value is added as a leaf with a random priority and then rotated up for as
+ * long as its priority is higher than its parent's. Duplicate values are ignored.
+ *
+ * @param _value The value to be inserted into the treap.
+ *******************************************************************************/
+template <typename T>
+void Treap<T>::insert(const T &_value)
+{
+    Path path;
+    BinTree *slot = &this->get_root(); // Slot where the walk currently is
+
+    while (*slot) // Walk down to the empty slot for the value
+    {
+        path.push_back(slot);
+        if (_value < (*slot)->data)
+            slot = &(*slot)->left;
+        else if ((*slot)->data < _value)
+            slot = &(*slot)->right;
+        else
+            return; // Already in the tree
+    }
+
+    *slot = this->make_node(_value);
+    (*slot)->balance_factor = NextPriority();
+    ++this->m_Size;
+
+    size_t node = path.size(); // Index of the slot of the new node
+    path.push_back(slot);
+
+    while (node > 0 && (*path[node - 1])->balance_factor < (*path[node])->balance_factor)
+    {
+        if ((*path[node - 1])->left == *path[node]) // Rotate the node above its parent
+            RightRotation(*path[node - 1]);
+        else
+            LeftRotation(*path[node - 1]);
+        --node;
+    }
+
+    for (size_t i = node; i-- > 0;) // The ancestors above it gained a node
+        this->update_node(*path[i]);
+}
+
+/*!*****************************************************************************
+ * @brief Removes a value from the treap.
+ *
+ * The node is rotated down, always lifting the child with the higher priority,
+ * until it has at most one child and can be unlinked. The cached counts and
+ * heights on the path are then refreshed.
+ *
+ * @param _value The value to be removed from the treap.
+ *******************************************************************************/
+template <typename T>
+void Treap<T>::remove(const T &_value)
+{
+    Path path;
+    BinTree *slot = &this->get_root(); // Slot where the walk currently is
+
+    while (*slot) // Walk down to the node holding the value
+    {
+        if (_value < (*slot)->data)
+        {
+            path.push_back(slot);
+            slot = &(*slot)->left;
+        }
+        else if ((*slot)->data < _value)
+        {
+            path.push_back(slot);
+            slot = &(*slot)->right;
+        }
+        else
+            break;
+    }
+
+    BinTree node = *slot;
+    if (node == nullptr) // Not in the tree
+        return;
+
+    while (node->left && node->right) // Rotate it down below the higher priority child
+    {
+        if (node->left->balance_factor > node->right->balance_factor)
+        {
+            RightRotation(*slot);
+            path.push_back(slot);
+            slot = &(*slot)->right;
+        }
+        else
+        {
+            LeftRotation(*slot);
+            path.push_back(slot);
+            slot = &(*slot)->left;
+        }
+    }
+
+    *slot = node->left ? node->left : node->right; // Unlink it
+    this->free_node(node);
+    --this->m_Size;
+
+    for (size_t i = path.size(); i-- > 0;) // Refresh the cached metrics bottom-up
+        this->update_node(*path[i]);
+}
+
+/*!*****************************************************************************
+ * @brief Restores the heap order after clear, build_from_sorted or bulk_insert.
+ *
+ * Those leave a balanced tree with the priorities of a plain BST, so fresh
+ * random priorities are handed out.
+ *******************************************************************************/
+template <typename T>
+void Treap<T>::rebuilt()
+{
+    AssignPriorities();
+}
+
+/*!*****************************************************************************
+ * @brief Returns the number of rotations done by this treap.
+ *
+ * @return The number of rotations since the treap was constructed.
+ *******************************************************************************/
+template <typename T>
+unsigned long long Treap<T>::rotations() const
+{
+    return m_Rotations;
+}
+
+/*!*****************************************************************************
+ * @brief Generates the next random priority.
+ *
+ * @return A priority in [0, 2^31).
+ *******************************************************************************/
+template <typename T>
+int Treap<T>::NextPriority()
+{
+    // xorshift32, fast and good enough for balancing
+    m_Seed ^= m_Seed << 13;
+    m_Seed ^= m_Seed >> 17;
+    m_Seed ^= m_Seed << 5;
+    return static_cast<int>(m_Seed >> 1);
+}
+
+/*!*****************************************************************************
+ * @brief Gives every node a random priority that respects the heap order.
+ *
+ * One random priority is drawn per node, and they are handed out from highest
+ * to lowest in breadth-first order, so every parent gets a higher priority than
+ * its children whatever shape the tree has.
+ *******************************************************************************/
+template <typename T>
+void Treap<T>::AssignPriorities()
+{
+    std::vector<int> priorities(this->size());
+    for (size_t i = 0; i < priorities.size(); ++i)
+        priorities[i] = NextPriority();
+    std::sort(priorities.begin(), priorities.end(), std::greater<int>()); // Highest first
+
+    std::vector<BinTree> queue; // Nodes in breadth-first order
+    queue.reserve(priorities.size());
+    if (this->get_root())
+        queue.push_back(this->get_root());
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        queue[i]->balance_factor = priorities[i];
+        if (queue[i]->left)
+            queue.push_back(queue[i]->left);
+        if (queue[i]->right)
+            queue.push_back(queue[i]->right);
+    }
+}
+
+/*!*****************************************************************************
+ * @brief Performs a left rotation on the given subtree.
+ *
+ * The cached count and height of the two nodes that moved are refreshed.
+ *
+ * @param _tree Reference to the root of the subtree to be rotated.
+ *******************************************************************************/
+template <typename T>
+void Treap<T>::LeftRotation(BinTree &_tree)
+{
+    BinTree newRoot = _tree->right; // The right child becomes the new root of the rotated subtree
+    _tree->right = newRoot->left;   // Its left subtree moves under the old root
+    newRoot->left = _tree;          // The old root becomes the left child of the new root
+    this->update_node(_tree);       // The old root is now below the new root, so refresh it first
+    this->update_node(newRoot);     // Then refresh the new root
+    _tree = newRoot;
+    ++m_Rotations; // Count it for rotations()
+}
+
+/*!*****************************************************************************
+ * @brief Performs a right rotation on the given subtree.
+ *
+ * The cached count and height of the two nodes that moved are refreshed.
+ *
+ * @param _tree Reference to the root of the subtree to be rotated.
+ *******************************************************************************/
+template <typename T>
+void Treap<T>::RightRotation(BinTree &_tree)
+{
+    BinTree newRoot = _tree->left; // The left child becomes the new root of the rotated subtree
+    _tree->left = newRoot->right;  // Its right subtree moves under the old root
+    newRoot->right = _tree;        // The old root becomes the right child of the new root
+    this->update_node(_tree);      // The old root is now below the new root, so refresh it first
+    this->update_node(newRoot);    // Then refresh the new root
+    _tree = newRoot;
+    ++m_Rotations; // Count it for rotations()
+}
@@ -0,0 +1,59 @@
+/*!*************************************************************************
+\file Treap.h
+\author Seetoh Wei Tung
+\par DP email: seetoh.w@digipen.edu
+\par Course: Data Structures
+\par Assignment 3
+\date 02-23-2024
+\brief
+This file contains the declaration for the Treap
+***************************************************************************/
+//---------------------------------------------------------------------------
+#ifndef TREAP_H
+#define TREAP_H
+//---------------------------------------------------------------------------
+#include <vector>     // std::vector
+#include <algorithm>  // std::sort
+#include <functional> // std::greater
+#include "BSTree.h"
+
+/*!
+  Definition for the Treap
+
+  Every node gets a random priority, kept in its balance_factor, and the tree
+  is a binary search tree on the values and a max-heap on the priorities. The
+  shape is then that of a BST built from a random insertion order, so the
+  expected height is O(log n) whatever order the values arrive in. An insert
+  needs fewer than two rotations on average.
+*/
+template <typename T>
+class Treap : public BSTree<T>
+{
+  public:
+    Treap(ObjectAllocator *oa = 0, bool ShareOA = false, unsigned seed = 2463534242u);
+    virtual ~Treap() = default;
+    virtual void insert(const T& value) override;
+    virtual void remove(const T& value) override;
+    unsigned long long rotations() const;
+
+  protected:
+    virtual void rebuilt() override;
+
+  private:
+    using BinTree = typename BSTree<T>::BinTree;
+    using Path = std::vector<BinTree *>;
+
+    int NextPriority();
+    void AssignPriorities();
+
+    void LeftRotation(BinTree& tree);
+    void RightRotation(BinTree& tree);
+
+    unsigned m_Seed;                //!< State of the priority generator
+    unsigned long long m_Rotations; //!< Rotations done since construction
+};
+
+#include "Treap.cpp"
+
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,608 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+
+#include "BSTree.h"
+#include "AVLTree.h"
+#include "RCUTree.h"
+#include "BTree.h"
+#include "RBTree.h"
+#include "Treap.h"
+#include "CompactAVLTree.h"
+#include "PersistentAVLTree.h"
+#include "PRNG.h"
+#include "ObjectAllocator.h"
+
+const char *gFile = "lexicon.txt";
+int gRounds = 5;
+
+using std::cout;
+using std::endl;
+
+//*********************************************************************
+// Helpers
+//*********************************************************************
+int RandomInt(int low, int high)
+{
+  return Digipen::Utils::Random(low, high);
+}
+
+template <typename T>
+void Shuffle(std::vector<T> &array)
+{
+  int count = static_cast<int>(array.size());
+  for (int i = 0; i < count; i++)
+  {
+    int r = RandomInt(0, count - 1);
+    std::swap(array[i], array[r]);
+  }
+}
+
+char *mystrupr(char *string)
+{
+  char *p = string;
+  while (*p)
+  {
+    if (*p >= 'a' && *p <= 'z')
+      *p -= 32;
+    p++;
+  }
+
+  return string;
+}
+
+  // Reads the dictionary into a sorted vector of unique upper-case words
+bool LoadWords(std::vector<std::string> &words, const char *filename)
+{
+  std::ifstream infile(filename);
+  if (!infile.is_open())
+  {
+    std::cout << "Can't open file: " << filename << std::endl;
+    return false;
+  }
+
+  std::string word;
+  while (std::getline(infile, word))
+  {
+    mystrupr(const_cast<char *>(word.c_str()));
+    words.push_back(word);
+  }
+
+  std::sort(words.begin(), words.end());
+  words.erase(std::unique(words.begin(), words.end()), words.end());
+  return true;
+}
+
+  // Every word of the dictionary plus a misspelled copy of each, shuffled
+std::vector<std::string> MakeQueries(const std::vector<std::string> &words)
+{
+  std::vector<std::string> queries;
+  queries.reserve(words.size() * 2);
+  for (size_t i = 0; i < words.size(); i++)
+  {
+    queries.push_back(words[i]);
+    queries.push_back(words[i] + "Q");
+  }
+
+  Digipen::Utils::srand(1, 2);
+  Shuffle(queries);
+  return queries;
+}
+
+  // Runs every query gRounds times, returns the elapsed milliseconds
+template <typename Tree, typename Key>
+double TimeLookups(const Tree &tree, const std::vector<Key> &queries,
+                   unsigned &found, unsigned long long &compares)
+{
+  found = 0;
+  compares = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int r = 0; r < gRounds; r++)
+  {
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+      unsigned count = 0;
+      if (tree.find(queries[i], count))
+        found++;
+      compares += count;
+    }
+  }
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void PrintResult(const char *name, double ms, unsigned found, unsigned long long compares, size_t lookups)
+{
+  cout << std::left << std::setw(18) << name << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ms << " ms";
+  cout << "  ns/lookup: " << std::setw(7) << std::setprecision(1) << ms * 1e6 / static_cast<double>(lookups);
+  cout << "  found: " << found << "  compares: " << compares << endl;
+}
+
+  // Builds a tree from keys in the given order, then times the lookups
+template <typename Tree, typename Key>
+void TimeTree(const char *name, const std::vector<Key> &keys, const std::vector<Key> &queries)
+{
+  Tree tree;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    tree.insert(keys[i]);
+  double insertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  unsigned found;
+  unsigned long long compares;
+  double ms = TimeLookups(tree, queries, found, compares);
+  cout << std::left << std::setw(18) << name << std::right;
+  cout << " height: " << std::setw(2) << tree.height();
+  cout << "  insert: " << std::setw(8) << std::fixed << std::setprecision(2) << insertMs << " ms" << endl;
+  PrintResult("", ms, found, compares, queries.size() * gRounds);
+}
+
+  // Applies a write workload to a balanced tree, then reports rotations and lookup depth
+template <typename Tree>
+void TimeBalance(const char *name, const std::vector<std::string> &inserts,
+                 const std::vector<std::string> &removes, const std::vector<std::string> &queries)
+{
+  Tree tree;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < inserts.size(); i++)
+    tree.insert(inserts[i]);
+  for (size_t i = 0; i < removes.size(); i++)
+    tree.remove(removes[i]);
+  double writeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  unsigned found;
+  unsigned long long compares;
+  double ms = TimeLookups(tree, queries, found, compares);
+  size_t writes = inserts.size() + removes.size();
+  size_t lookups = queries.size() * gRounds;
+
+  cout << std::left << std::setw(8) << name << std::right << std::fixed;
+  cout << " writes: " << std::setw(8) << std::setprecision(2) << writeMs << " ms";
+  cout << "  rotations/write: " << std::setw(5) << std::setprecision(3) << double(tree.rotations()) / static_cast<double>(writes);
+  cout << "  height: " << std::setw(2) << tree.height();
+  cout << "  compares/lookup: " << std::setw(6) << std::setprecision(2) << double(compares) / static_cast<double>(lookups);
+  cout << "  ns/lookup: " << std::setw(7) << std::setprecision(1) << ms * 1e6 / static_cast<double>(lookups) << endl;
+}
+
+  // Runs one write workload on every balanced tree
+void TimeBalanceAll(const char *workload, const std::vector<std::string> &inserts,
+                    const std::vector<std::string> &removes, const std::vector<std::string> &queries)
+{
+  cout << workload << ": " << inserts.size() << " inserts, " << removes.size() << " removes" << endl;
+  TimeBalance<AVLTree<std::string> >("AVLTree", inserts, removes, queries);
+  TimeBalance<RBTree<std::string> >("RBTree", inserts, removes, queries);
+  TimeBalance<Treap<std::string> >("Treap", inserts, removes, queries);
+}
+
+  // AVLTree against CompactAVLTree on the same keys: node memory and lookup time
+template <typename Key>
+void TimeCompact(const std::vector<Key> &keys, const std::vector<Key> &queries)
+{
+  AVLTree<Key> tree;
+  CompactAVLTree<Key> compact;
+  for (size_t i = 0; i < keys.size(); i++)
+  {
+    tree.insert(keys[i]);
+    compact.insert(keys[i]);
+  }
+
+  size_t nodeBytes = sizeof(typename AVLTree<Key>::BinTreeNode);
+  size_t compactBytes = sizeof(typename CompactAVLTree<Key>::CompactNode);
+  cout << "node size: " << nodeBytes << " vs " << compactBytes << " bytes";
+  cout << ", node memory: " << nodeBytes * tree.size() / 1024 << " KB (plus one heap block each) vs ";
+  cout << compactBytes * compact.size() / 1024 << " KB (" << compact.memory_used() / 1024 << " KB reserved)" << endl;
+
+  unsigned found;
+  unsigned long long compares;
+  double ms = TimeLookups(tree, queries, found, compares);
+  PrintResult("AVLTree", ms, found, compares, queries.size() * gRounds);
+  ms = TimeLookups(compact, queries, found, compares);
+  PrintResult("CompactAVLTree", ms, found, compares, queries.size() * gRounds);
+}
+
+  // Copies and clears a tree gRounds times, with a shared allocator or the private arena
+template <typename Key>
+void TimeCopy(const char *name, const std::vector<Key> &keys, bool shareOA)
+{
+  AVLTree<Key> tree(0, shareOA);
+  tree.build_from_sorted(keys.begin(), keys.end());
+
+  double copyMs = 0, clearMs = 0;
+  for (int round = 0; round < gRounds; round++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    AVLTree<Key> copy(tree);
+    auto copied = std::chrono::steady_clock::now();
+    copy.clear();
+    auto cleared = std::chrono::steady_clock::now();
+    copyMs += std::chrono::duration<double, std::milli>(copied - start).count();
+    clearMs += std::chrono::duration<double, std::milli>(cleared - copied).count();
+  }
+
+  cout << std::left << std::setw(18) << name << std::right << std::fixed << std::setprecision(2);
+  cout << "copy: " << std::setw(8) << copyMs / gRounds << " ms, clear: ";
+  cout << std::setw(8) << clearMs / gRounds << " ms" << endl;
+}
+
+  // Keeps a version of the tree after every batch of updates, returns the elapsed milliseconds
+template <typename Tree>
+double TimeVersions(std::vector<Tree> &versions, const std::vector<std::string> &words,
+                    const std::vector<std::string> &updates, size_t batch)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  Tree tree;
+  for (size_t i = 0; i < words.size(); i++)
+    tree.insert(words[i]);
+
+  for (size_t i = 0; i < updates.size(); i++)
+  {
+    if (i % batch == 0)
+      versions.push_back(tree); // Keep the current version
+    if (i % 2)
+      tree.remove(updates[i]);
+    else
+      tree.insert(updates[i]);
+  }
+  versions.push_back(tree);
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//*********************************************************************
+// Benchmarks
+//*********************************************************************
+
+  // Pointer tree against its frozen Eytzinger snapshot, same keys and shape
+void BenchFreeze(void)
+{
+  const char *test = "BenchFreeze";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  std::vector<std::string> words;
+  if (!LoadWords(words, gFile))
+    return;
+  std::vector<std::string> queries = MakeQueries(words);
+  size_t lookups = queries.size() * gRounds;
+
+  try
+  {
+    AVLTree<std::string> tree;
+    tree.build_from_sorted(words.begin(), words.end());
+    BSTSnapshot<std::string> snapshot = tree.freeze();
+
+    cout << "words: " << tree.size() << ", height: " << tree.height();
+    cout << ", lookups: " << lookups << endl;
+
+    unsigned found;
+    unsigned long long compares;
+    double ms = TimeLookups(tree, queries, found, compares);
+    PrintResult("pointer tree", ms, found, compares, lookups);
+
+    ms = TimeLookups(snapshot, queries, found, compares);
+    PrintResult("frozen snapshot", ms, found, compares, lookups);
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": " << e.what() << std::endl;
+  }
+}
+
+  // Read throughput of the RCU tree for 1-32 readers while one writer updates it
+void BenchConcurrentReads(void)
+{
+  const char *test = "BenchConcurrentReads";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  std::vector<std::string> words;
+  if (!LoadWords(words, gFile))
+    return;
+  std::vector<std::string> queries = MakeQueries(words);
+
+  try
+  {
+    RCUTree<std::string> tree;
+    const BSTree<std::string> &base = tree; // Readers go through the base class, as generic code would
+    tree.build_from_sorted(words.begin(), words.end());
+    cout << "words: " << tree.size() << ", height: " << tree.height() << endl;
+
+    const int durationMs = 100 * gRounds; // Length of each run
+    for (int readers = 1; readers <= 32; readers *= 2)
+    {
+      std::atomic<bool> stop(false);
+      std::atomic<unsigned long long> lookups(0);
+      std::atomic<unsigned long long> found(0);
+      std::vector<std::thread> threads;
+
+        // Readers look up the queries round-robin until told to stop
+      for (int r = 0; r < readers; r++)
+      {
+        threads.push_back(std::thread([&, r]() {
+          unsigned long long done = 0, hits = 0;
+          size_t i = static_cast<size_t>(r) * 7919 % queries.size();
+          while (!stop.load(std::memory_order_relaxed))
+          {
+            unsigned compares = 0;
+            if (base.find(queries[i], compares)) // Use the result so the lookup is not optimized away
+              ++hits;
+            if (++i == queries.size())
+              i = 0;
+            ++done;
+          }
+          lookups += done;
+          found += hits;
+        }));
+      }
+
+        // The writer adds and removes a word every millisecond
+      unsigned long long writes = 0;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      std::chrono::steady_clock::time_point end = start + std::chrono::milliseconds(durationMs);
+      while (std::chrono::steady_clock::now() < end)
+      {
+        std::string word = queries[writes % queries.size()] + "W";
+        tree.insert(word);
+        tree.remove(word);
+        writes += 2;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      stop = true;
+      for (size_t t = 0; t < threads.size(); t++)
+        threads[t].join();
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+      cout << "readers: " << std::setw(2) << readers;
+      cout << "  lookups/s: " << std::setw(12) << std::fixed << std::setprecision(0) << static_cast<double>(lookups) * 1000.0 / ms;
+      cout << "  found: " << std::setprecision(1) << 100.0 * static_cast<double>(found) / static_cast<double>(lookups) << "%";
+      cout << "  writes: " << writes << endl;
+    }
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": " << e.what() << std::endl;
+  }
+}
+
+  // BSTree, AVLTree and BTree on the dictionary and on random integers
+void BenchTrees(void)
+{
+  const char *test = "BenchTrees";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  std::vector<std::string> words;
+  if (!LoadWords(words, gFile))
+    return;
+
+  try
+  {
+      // Dictionary words, inserted in random order
+    std::vector<std::string> queries = MakeQueries(words);
+    std::vector<std::string> keys = words;
+    Shuffle(keys);
+    cout << "words: " << keys.size() << ", lookups: " << queries.size() * gRounds << endl;
+    TimeTree<BSTree<std::string> >("BSTree", keys, queries);
+    TimeTree<AVLTree<std::string> >("AVLTree", keys, queries);
+    TimeTree<BTree<std::string, 16> >("BTree<16>", keys, queries);
+    TimeTree<BTree<std::string, 64> >("BTree<64>", keys, queries);
+
+      // As many random integers, half of the lookups miss
+    std::vector<int> numbers, numberQueries;
+    Digipen::Utils::srand(3, 4);
+    for (size_t i = 0; i < words.size(); i++)
+    {
+      int value = RandomInt(0, 1 << 30) * 2; // Even values are inserted
+      numbers.push_back(value);
+      numberQueries.push_back(value);
+      numberQueries.push_back(value + 1);
+    }
+    Shuffle(numberQueries);
+    cout << "\nintegers: " << numbers.size() << ", lookups: " << numberQueries.size() * gRounds << endl;
+    TimeTree<BSTree<int> >("BSTree", numbers, numberQueries);
+    TimeTree<AVLTree<int> >("AVLTree", numbers, numberQueries);
+    TimeTree<BTree<int, 16> >("BTree<16>", numbers, numberQueries);
+    TimeTree<BTree<int, 64> >("BTree<64>", numbers, numberQueries);
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": " << e.what() << std::endl;
+  }
+}
+
+  // AVLTree, RBTree and Treap on sorted, random and write-heavy workloads
+void BenchBalance(void)
+{
+  const char *test = "BenchBalance";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  std::vector<std::string> words;
+  if (!LoadWords(words, gFile))
+    return;
+
+  try
+  {
+    std::vector<std::string> queries = MakeQueries(words);
+    std::vector<std::string> none;
+
+      // Sorted input is the worst case for rotations
+    TimeBalanceAll("sorted", words, none, queries);
+
+    std::vector<std::string> shuffled = words;
+    Shuffle(shuffled);
+    TimeBalanceAll("random", shuffled, none, queries);
+
+      // Insert everything, then remove every other word in random order
+    std::vector<std::string> removes;
+    for (size_t i = 0; i < shuffled.size(); i += 2)
+      removes.push_back(shuffled[i]);
+    TimeBalanceAll("churn", shuffled, removes, queries);
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": " << e.what() << std::endl;
+  }
+}
+
+  // Pointer nodes against 32-bit index nodes, on integers and on the dictionary
+void BenchCompact(void)
+{
+  const char *test = "BenchCompact";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  std::vector<std::string> words;
+  if (!LoadWords(words, gFile))
+    return;
+
+  try
+  {
+    std::vector<int> numbers, numberQueries;
+    Digipen::Utils::srand(3, 4);
+    for (size_t i = 0; i < words.size(); i++)
+    {
+      int value = RandomInt(0, 1 << 30) * 2; // Even values are inserted
+      numbers.push_back(value);
+      numberQueries.push_back(value);
+      numberQueries.push_back(value + 1);
+    }
+    Shuffle(numberQueries);
+    cout << "integers: " << numbers.size() << endl;
+    TimeCompact(numbers, numberQueries);
+
+    std::vector<std::string> keys = words;
+    Shuffle(keys);
+    cout << "\nwords: " << keys.size() << endl;
+    TimeCompact(keys, MakeQueries(words));
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": " << e.what() << std::endl;
+  }
+}
+
+  // Copy and clear with a shared ObjectAllocator against the private node arena
+void BenchCopy(void)
+{
+  const char *test = "BenchCopy";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  std::vector<std::string> words;
+  if (!LoadWords(words, gFile))
+    return;
+
+  try
+  {
+    std::vector<int> numbers;
+    for (size_t i = 0; i < words.size(); i++)
+      numbers.push_back(static_cast<int>(i));
+
+    cout << "integers: " << numbers.size() << endl;
+    TimeCopy("shared allocator", numbers, true);
+    TimeCopy("node arena", numbers, false);
+
+    cout << "\nwords: " << words.size() << endl;
+    TimeCopy("shared allocator", words, true);
+    TimeCopy("node arena", words, false);
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": " << e.what() << std::endl;
+  }
+}
+
+  // Keeping old versions: deep copies of an AVLTree against persistent snapshots
+void BenchVersions(void)
+{
+  const char *test = "BenchVersions";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  std::vector<std::string> words;
+  if (!LoadWords(words, gFile))
+    return;
+
+  try
+  {
+    std::vector<std::string> updates = MakeQueries(words);
+    updates.resize(std::min<size_t>(updates.size(), 2000));
+    size_t batch = 20;
+
+    std::vector<AVLTree<std::string> > copies;
+    double ms = TimeVersions(copies, words, updates, batch);
+    size_t values = 0;
+    for (size_t i = 0; i < copies.size(); i++)
+      values += copies[i].size();
+    cout << "versions: " << copies.size() << ", values in all versions: " << values << endl;
+    cout << std::left << std::setw(18) << "deep copies" << std::right;
+    cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ms << " ms";
+    cout << "  nodes: " << values << endl;
+    copies.clear();
+
+    std::vector<PersistentAVLTree<std::string> > snapshots;
+    ms = TimeVersions(snapshots, words, updates, batch);
+    cout << std::left << std::setw(18) << "snapshots" << std::right;
+    cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ms << " ms";
+    cout << "  nodes: " << snapshots.back().nodes_in_use() << endl;
+
+    unsigned found;
+    unsigned long long compares;
+    std::vector<std::string> queries = MakeQueries(words);
+    ms = TimeLookups(snapshots.front(), queries, found, compares);
+    PrintResult("oldest snapshot", ms, found, compares, queries.size() * gRounds);
+    ms = TimeLookups(snapshots.back(), queries, found, compares);
+    PrintResult("newest snapshot", ms, found, compares, queries.size() * gRounds);
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": " << e.what() << std::endl;
+  }
+}
+
+//***********************************************************************
+//***********************************************************************
+//***********************************************************************
+
+int main(int argc, char **argv)
+{
+    // Benchmark number
+  int test_num = 0;
+  if (argc > 1)
+    test_num = std::atoi(argv[1]);
+
+    // Dictionary
+  if (argc > 2)
+    gFile = argv[2];
+
+    // Repetitions of each workload
+  if (argc > 3)
+    gRounds = std::atoi(argv[3]);
+
+  typedef void (*BenchFn)(void);
+  BenchFn Tests[] = {
+                     BenchFreeze,          // 1 pointer tree vs frozen snapshot
+                     BenchConcurrentReads, // 2 RCU tree, 1-32 readers and one writer
+                     BenchTrees,           // 3 BSTree vs AVLTree vs BTree
+                     BenchBalance,         // 4 AVLTree vs RBTree vs Treap
+                     BenchCompact,         // 5 pointer nodes vs 32-bit index nodes
+                     BenchCopy,            // 6 shared allocator vs node arena
+                     BenchVersions,        // 7 deep copies vs persistent snapshots
+                    };
+
+  int num = sizeof(Tests) / sizeof(*Tests);
+  if (test_num == 0)
+  {
+    for (int i = 0; i < num; i++)
+      Tests[i]();
+  }
+  else if (test_num > 0 && test_num <= num)
+  {
+    Tests[test_num - 1]();
+  }
+
+  return 0;
+}
@@ -212,14 +212,18 @@ bool LoadDictionary(T& tree, const char *filename)
   }
 
   std::string word;
+  std::vector<std::string> words;
   while (!infile.eof())
   {
     if (std::getline(infile, word).eof())
       break;
 
     mystrupr(const_cast<char *>(word.c_str()));
-    tree.insert(word);
+    words.push_back(word);
   }
+
+    // Build the whole dictionary at once (balanced, even for sorted word lists)
+  tree.bulk_insert(words.begin(), words.end());
   return true;
 }
 
@@ -338,6 +342,68 @@ void TestSpellCheck2(void)
   }
 }
 
+  // Suggests words for misspellings from the words sharing their first letters
+template <typename T>
+void TestSpellCheck3(void)
+{
+  const char *test = "TestSpellCheck3";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  try
+  {
+    T tree;
+
+    if (!LoadDictionary(tree, gFile))
+      return;
+
+    PrintInfo(tree);
+    std::string words[] = {"SEVN", "FAWTHERS", "FOARTH", "CONTNENT", "NASHUN"};
+    const unsigned max_suggestions = 5;
+
+    unsigned compares;
+    int num_words = sizeof(words) / sizeof(*words);
+    for (int i = 0; i < num_words; i++)
+    {
+      compares = 0;
+      if (tree.find(words[i], compares))
+        continue;
+
+        // Shorten the word until some dictionary words start with it
+      std::string prefix = words[i].substr(0, words[i].size() - 1);
+      while (!prefix.empty())
+      {
+        const typename T::BinTreeNode *first = tree.lower_bound(prefix);
+        if (first && first->data.compare(0, prefix.size(), prefix) == 0)
+          break;
+        prefix.erase(prefix.size() - 1);
+      }
+
+      std::cout << words[i] << " is misspelled. " << prefix << "*:";
+      unsigned shown = 0;
+      for (const std::string &suggestion : tree.prefix_range(prefix))
+      {
+        if (shown++ == max_suggestions) // Only the first few are walked
+          break;
+        std::cout << " " << suggestion;
+      }
+      std::cout << std::endl;
+    }
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": ";
+    int value = e.code();
+    if (value == BSTException::E_NO_MEMORY)
+      std::cout << "E_NO_MEMORY" << std::endl;
+    else
+      std::cout << "Unknown error code." << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << "Unknown exception." << std::endl;
+  }
+}
+
 //***********************************************************************
 //***********************************************************************
 //***********************************************************************
@@ -444,6 +510,8 @@ int main(int argc, char **argv)
                        {TestSpellCheck1<AVLTree<U> >, 10000, 5000}, 
                        {TestSpellCheck2<BSTree<U> >,  10000, 5000}, 
                        {TestSpellCheck2<AVLTree<U> >, 10000, 5000}, 
+                       {TestSpellCheck3<BSTree<U> >,  10000, 5000}, 
+                       {TestSpellCheck3<AVLTree<U> >, 10000, 5000}, 
                       };
 
   int num = sizeof(Tests) / sizeof(*Tests);
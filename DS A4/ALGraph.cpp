@@ -10,13 +10,191 @@ This file contains the implementation for the ALGraph
 ***************************************************************************/
 #include "ALGraph.h"
 #include <algorithm>
-#include <queue>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <system_error>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+namespace
+{
+  /**
+   * Reads a stream one line at a time through a large buffer, so that big
+   * edge files are parsed without a stream extraction per number
+   */
+  class LineReader
+  {
+  public:
+    LineReader(std::istream &stream) : m_Stream(stream), m_Buffer(1 << 20), m_Begin(0), m_End(0) {}
+
+    /**
+     * Get the next line, without its line break
+     * @param begin Set to the first character of the line
+     * @param end Set to one past the last character of the line
+     * @return False at the end of the stream
+     */
+    bool NextLine(const char *&begin, const char *&end)
+    {
+      for (;;)
+      {
+        const char *first = m_Buffer.data() + m_Begin;
+        const char *last = m_Buffer.data() + m_End;
+        const char *newline = std::find(first, last, '\n');
+        if (newline != last || (m_Stream.eof() && first != last))
+        {
+          begin = first;
+          end = newline;
+          m_Begin = static_cast<size_t>(newline - m_Buffer.data()) + (newline != last);
+          return true;
+        }
+        if (m_Stream.eof() || m_Stream.bad())
+          return false;
+
+        // Keep the partial line at the front and read more after it
+        std::copy(m_Buffer.begin() + m_Begin, m_Buffer.begin() + m_End, m_Buffer.begin());
+        m_End -= m_Begin;
+        m_Begin = 0;
+        if (m_End == m_Buffer.size()) // The line does not fit
+          m_Buffer.resize(m_Buffer.size() * 2);
+        m_Stream.read(m_Buffer.data() + m_End, static_cast<std::streamsize>(m_Buffer.size() - m_End));
+        m_End += static_cast<size_t>(m_Stream.gcount());
+      }
+    }
+
+  private:
+    std::istream &m_Stream;
+    std::vector<char> m_Buffer;
+    size_t m_Begin; // start of the unread part of m_Buffer
+    size_t m_End;   // end of the data in m_Buffer
+  };
+
+  /**
+   * Read an unsigned number, skipping blanks in front of it
+   * @param text The position to read from, moved past the number
+   * @param end The end of the line
+   * @param value Set to the number
+   * @return False if there is no number
+   */
+  bool ReadNumber(const char *&text, const char *end, unsigned &value)
+  {
+    while (text != end && (*text == ' ' || *text == '\t' || *text == '\r'))
+      ++text;
+    if (text == end || *text < '0' || *text > '9')
+      return false;
+
+    value = 0;
+    while (text != end && *text >= '0' && *text <= '9')
+      value = value * 10 + static_cast<unsigned>(*text++ - '0');
+    return true;
+  }
+
+  /**
+   * Lets a fixed group of threads wait for each other between the phases of
+   * a parallel algorithm, sleeping instead of spinning
+   */
+  class PhaseBarrier
+  {
+  public:
+    PhaseBarrier(unsigned count) : m_Count(count), m_Waiting(0), m_Generation(0) {}
+
+    /**
+     * Block until every thread of the group has called Wait
+     */
+    void Wait(void)
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      unsigned generation = m_Generation;
+      if (++m_Waiting == m_Count) // The last one releases the others
+      {
+        m_Waiting = 0;
+        ++m_Generation;
+        m_Released.notify_all();
+        return;
+      }
+      m_Released.wait(lock, [&] { return generation != m_Generation; });
+    }
+
+    /**
+     * Change the size of the group, before anyone is released by Wait
+     * @param count The new number of threads
+     */
+    void Resize(unsigned count)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Count = count;
+    }
+
+  private:
+    std::mutex m_Mutex;
+    std::condition_variable m_Released;
+    unsigned m_Count;
+    unsigned m_Waiting;
+    unsigned m_Generation;
+  };
+
+  const char HIERARCHY_MAGIC[8] = {'A', 'L', 'G', 'C', 'H', '0', '0', '1'};
+
+  /**
+   * Write the elements of a vector as raw bytes
+   * @param stream The stream to write to
+   * @param data The elements
+   */
+  template <typename T>
+  void WriteArray(std::ostream &stream, const std::vector<T> &data)
+  {
+    if (!data.empty())
+      stream.write(reinterpret_cast<const char *>(data.data()),
+                   static_cast<std::streamsize>(data.size() * sizeof(T)));
+  }
+
+  /**
+   * Read raw bytes into the elements of a vector
+   * The vector grows a chunk at a time as the bytes arrive, so a count that
+   * is far larger than the stream fails when the stream ends instead of
+   * allocating it all up front.
+   * @param stream The stream to read from
+   * @param data Resized to count and filled
+   * @param count The number of elements to read
+   * @return False if the stream ended early
+   */
+  template <typename T>
+  bool ReadArray(std::istream &stream, std::vector<T> &data, size_t count)
+  {
+    const size_t CHUNK = (1u << 20) / sizeof(T); // Elements read at a time
+    data.clear();
+    while (stream && data.size() < count)
+    {
+      size_t done = data.size();
+      data.resize(done + std::min(CHUNK, count - done));
+      stream.read(reinterpret_cast<char *>(data.data() + done),
+                  static_cast<std::streamsize>((data.size() - done) * sizeof(T)));
+    }
+    return static_cast<bool>(stream);
+  }
+
+  /**
+   * Add the bytes of a vector to an FNV-1a hash
+   * @param hash The hash so far
+   * @param data The elements
+   */
+  template <typename T>
+  void HashArray(unsigned long long &hash, const std::vector<T> &data)
+  {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data.data());
+    for (size_t i = 0; i < data.size() * sizeof(T); ++i)
+      hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+  }
+}
 
 /**
  * Constructor for the ALGraph class
  * @param size The number of nodes in the graph
  */
 ALGraph::ALGraph(unsigned size)
+  : m_Frozen(false), m_MinWeight(static_cast<unsigned>(-1)), m_MaxWeight(0)
 {
   m_AdjacencyList.reserve(size);
   for (size_t i = 0; i < size; ++i)
@@ -38,6 +216,10 @@ ALGraph::~ALGraph(void)
  */
 void ALGraph::AddDEdge(unsigned _source, unsigned _destination, unsigned _weight)
 {
+    // Edges can only be added to the per-node lists
+    if (m_Frozen)
+      Thaw();
+
     // Calculate zero-based index for source to match internal storage
     unsigned zeroBasedIndex = _source - 1;
 
@@ -46,6 +228,8 @@ void ALGraph::AddDEdge(unsigned _source, unsigned _destination, unsigned _weight
 
     // Reference to the adjacency list of the source node
     auto &sourceAdjList = m_AdjacencyList.at(zeroBasedIndex);
+    m_MinWeight = std::min(m_MinWeight, _weight);
+    m_MaxWeight = std::max(m_MaxWeight, _weight);
 
     // Iterate through the adjacency list to find the correct position
     // for the new edge based on weight (and id for tie-breaking)
@@ -81,106 +265,2415 @@ void ALGraph::AddUEdge(unsigned node1, unsigned node2, unsigned weight)
 }
 
 /**
- * Perform Dijkstra's algorithm on the graph
- * @param _startNode The starting node for the algorithm
- * @return A vector of DijkstraInfo structs, one for each node in the graph
+ * Get the number of edges leaving a node
+ * @param node The 0-based node index
+ * @return The number of edges
  */
-std::vector<DijkstraInfo> ALGraph::Dijkstra(unsigned _startNode) const 
+unsigned ALGraph::OutDegree(unsigned node) const
+{
+  if (m_Frozen)
+    return m_Offsets[node + 1] - m_Offsets[node];
+  return static_cast<unsigned>(m_AdjacencyList[node].size());
+}
+
+/**
+ * Get the destination of one of the edges leaving a node
+ * @param node The 0-based node index
+ * @param index The position of the edge in the node's edges
+ * @return The 0-based destination
+ */
+unsigned ALGraph::Neighbour(unsigned node, unsigned index) const
+{
+  if (m_Frozen)
+    return m_Edges[m_Offsets[node] + index].to;
+  return m_AdjacencyList[node][index].id - 1;
+}
+
+/**
+ * Call a function for every edge leaving a node, in order
+ * @param node The 0-based node index
+ * @param visit Called with the 0-based destination and the weight
+ */
+template <typename Visit>
+void ALGraph::ForEachEdge(unsigned node, Visit visit) const
+{
+  if (m_Frozen)
+  {
+    const unsigned end = m_Offsets[node + 1];
+    for (unsigned edge = m_Offsets[node]; edge < end; ++edge)
+      visit(m_Edges[edge].to, m_Edges[edge].weight);
+  }
+  else
+  {
+    for (const AdjacencyInfo &info : m_AdjacencyList[node])
+      visit(info.id - 1, info.weight);
+  }
+}
+
+/**
+ * Call a function for every edge entering a node of a frozen graph
+ * @param node The 0-based node index
+ * @param visit Called with the 0-based source and the weight
+ */
+template <typename Visit>
+void ALGraph::ForEachInEdge(unsigned node, Visit visit) const
+{
+  const unsigned end = m_ReverseOffsets[node + 1];
+  for (unsigned edge = m_ReverseOffsets[node]; edge < end; ++edge)
+    visit(m_ReverseEdges[edge].to, m_ReverseEdges[edge].weight);
+}
+
+/**
+ * Add many directed (or undirected) edges at once
+ * Instead of inserting each edge into a sorted list, the edges are counted
+ * per source node, written straight into compressed sparse row form next to
+ * the existing edges, and each row is sorted once by weight and id. The
+ * graph is frozen afterwards; see Freeze.
+ * @param edges The edges to add, with 1-based node ids
+ * @param undirected Whether to add every edge in both directions
+ * @throw std::out_of_range if a node id is not in the graph; no edge is
+ *        added in that case
+ */
+void ALGraph::AddEdges(const std::vector<EdgeInfo> &edges, bool undirected)
+{
+  const unsigned size = Size();
+  for (const EdgeInfo &edge : edges)
+  {
+    if (edge.source < 1 || edge.source > size || edge.destination < 1 || edge.destination > size)
+      throw std::out_of_range("ALGraph::AddEdges: node id out of range");
+  }
+
+  // Counting pass: the number of edges leaving each node, existing ones first
+  std::vector<unsigned> offsets(size + 1, 0);
+  for (unsigned node = 0; node < size; ++node)
+  {
+    if (m_Frozen)
+      offsets[node + 1] = m_Offsets[node + 1] - m_Offsets[node];
+    else
+      offsets[node + 1] = static_cast<unsigned>(m_AdjacencyList[node].size());
+  }
+  for (const EdgeInfo &edge : edges)
+  {
+    ++offsets[edge.source];
+    if (undirected)
+      ++offsets[edge.destination];
+    m_MinWeight = std::min(m_MinWeight, edge.weight);
+    m_MaxWeight = std::max(m_MaxWeight, edge.weight);
+  }
+  for (unsigned node = 0; node < size; ++node)
+    offsets[node + 1] += offsets[node];
+
+  // Scatter the existing and the new edges into their rows
+  std::vector<PackedEdge> packed(offsets[size]);
+  std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+  for (unsigned node = 0; node < size; ++node)
+  {
+    ForEachEdge(node, [&](unsigned neighbour, unsigned weight)
+    {
+      packed[next[node]++] = PackedEdge{neighbour, weight};
+    });
+  }
+  for (const EdgeInfo &edge : edges)
+  {
+    packed[next[edge.source - 1]++] = PackedEdge{edge.destination - 1, edge.weight};
+    if (undirected)
+      packed[next[edge.destination - 1]++] = PackedEdge{edge.source - 1, edge.weight};
+  }
+
+  // Sort each row the way AddDEdge keeps its lists: by weight, then by id
+  auto less = [](const PackedEdge &lhs, const PackedEdge &rhs)
+  {
+    return lhs.weight < rhs.weight || (lhs.weight == rhs.weight && lhs.to < rhs.to);
+  };
+  for (unsigned node = 0; node < size; ++node)
+  {
+    auto first = packed.begin() + offsets[node];
+    auto last = packed.begin() + offsets[node + 1];
+    if (!std::is_sorted(first, last, less))
+      std::sort(first, last, less);
+  }
+
+  m_Offsets.swap(offsets);
+  m_Edges.swap(packed);
+  m_AdjacencyList.resize(0);
+  m_AdjacencyList.shrink_to_fit();
+  m_Frozen = true;
+  BuildReverse();
+  DropHierarchy();
+}
+
+/**
+ * Add the edges listed in a file
+ * See the stream version for the format.
+ * @param filename The name of the file
+ * @param undirected Whether to add every edge in both directions
+ * @return False if the file cannot be read or has a line that is not an edge
+ */
+bool ALGraph::LoadEdges(const char *filename, bool undirected)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open())
+    return false;
+  return LoadEdges(file, undirected);
+}
+
+/**
+ * Add the edges listed in a stream
+ * Each line holds one edge as "source destination weight", with 1-based
+ * node ids. Lines in the DIMACS shortest path format ("a source destination
+ * weight") are read too. Empty lines and lines starting with c, p, # or %
+ * are skipped. The stream is read in large blocks and all edges are added
+ * with one call to AddEdges.
+ * @param stream The stream to read
+ * @param undirected Whether to add every edge in both directions
+ * @return False if a line is not an edge, in which case no edge is added
+ * @throw std::out_of_range if a node id is not in the graph
+ */
+bool ALGraph::LoadEdges(std::istream &stream, bool undirected)
 {
-    // Lambda function to access adjacency list of a given node, adjusting for 0-based indexing
-    auto GetAdjList = [=](unsigned index) { return m_AdjacencyList.at(index - 1); };
+  std::vector<EdgeInfo> edges;
+  LineReader reader(stream);
+  const char *text, *end;
+  while (reader.NextLine(text, end))
+  {
+    while (text != end && (*text == ' ' || *text == '\t' || *text == '\r'))
+      ++text;
+    if (text == end || *text == 'c' || *text == 'p' || *text == '#' || *text == '%')
+      continue; // Blank line or comment
+    if (*text == 'a') // DIMACS arc
+      ++text;
 
-    // Priority queue comparison function; assumes definition of GNode supports < operator
-    auto comp = [](const GNode* lhs, const GNode* rhs) { return lhs->info.cost < rhs->info.cost; };
+    EdgeInfo edge;
+    if (!ReadNumber(text, end, edge.source) || !ReadNumber(text, end, edge.destination) ||
+        !ReadNumber(text, end, edge.weight))
+      return false;
+    edges.push_back(edge);
+  }
 
-    // Priority queue to manage nodes by minimum cost, initialized with custom comparator
-    std::priority_queue<GNode*, std::vector<GNode*>, decltype(comp)> pq(comp);
-    
-    // Preallocate memory for result vector to improve performance
-    std::vector<DijkstraInfo> dijkstraResults;
-    dijkstraResults.reserve(m_AdjacencyList.size());
+  if (stream.bad())
+    return false;
+
+  AddEdges(edges, undirected);
+  return true;
+}
 
-    // Container to store node states during algorithm execution
-    std::vector<GNode> nodes;
-    nodes.reserve(m_AdjacencyList.size());
+/**
+ * Change the weight of an edge
+ * Of several edges between the same two nodes, the lightest is changed. The
+ * edge moves to its place in the weight order of its node, and a frozen
+ * graph stays frozen. A contraction hierarchy is dropped.
+ * @param source The 1-based source node
+ * @param destination The 1-based destination node
+ * @param weight The new weight
+ * @return False if there is no such edge
+ * @throw std::out_of_range if a node is not in the graph
+ */
+bool ALGraph::UpdateEdgeWeight(unsigned source, unsigned destination, unsigned weight)
+{
+  const unsigned size = Size();
+  if (source < 1 || source > size || destination < 1 || destination > size)
+    throw std::out_of_range("ALGraph::UpdateEdgeWeight: node out of range");
 
-    // Initialize nodes with infinite cost and mark the start node
-    for (unsigned i = 0; i < m_AdjacencyList.size(); ++i) 
+  if (!m_Frozen)
+  {
+    auto &list = m_AdjacencyList[source - 1];
+    for (auto it = list.begin(); it != list.end(); ++it)
     {
-        GNode node;
-        node.m_id = i + 1; // Adjust for 1-based indexing
-        bool isStartNode = (node.m_id == _startNode);
-        node.info.cost = isStartNode ? 0 : INF;
-        node.m_Evaluated = isStartNode;
-        if (isStartNode) node.info.path.push_back(_startNode);
-        nodes.push_back(node);
+      if (it->id == destination)
+      {
+        list.erase(it);
+        AddDEdge(source, destination, weight); // Back in weight order
+        return true;
+      }
     }
+    return false;
+  }
+
+  const unsigned s = source - 1, d = destination - 1;
+  const unsigned first = m_Offsets[s], last = m_Offsets[s + 1];
+  unsigned at = first;
+  while (at < last && m_Edges[at].to != d)
+    ++at;
+  if (at == last)
+    return false;
+  const unsigned oldWeight = m_Edges[at].weight;
 
-    //push all nodes into queue with updated edge costs.
-    const auto &adj_nodes = GetAdjList(_startNode);
-    
-    for (unsigned i = 0; i < adj_nodes.size(); ++i)
+  // Slide the edge to its place in the row, which is ordered by weight and id
+  const PackedEdge edge{d, weight};
+  auto less = [](const PackedEdge &lhs, const PackedEdge &rhs)
+  {
+    return lhs.weight < rhs.weight || (lhs.weight == rhs.weight && lhs.to < rhs.to);
+  };
+  for (; at > first && less(edge, m_Edges[at - 1]); --at)
+    m_Edges[at] = m_Edges[at - 1];
+  for (; at + 1 < last && less(m_Edges[at + 1], edge); ++at)
+    m_Edges[at] = m_Edges[at + 1];
+  m_Edges[at] = edge;
+
+  for (unsigned back = m_ReverseOffsets[d]; back < m_ReverseOffsets[d + 1]; ++back)
+  {
+    if (m_ReverseEdges[back].to == s && m_ReverseEdges[back].weight == oldWeight)
     {
-        const auto &info = adj_nodes.at(i);
-        auto &node = nodes[info.id - 1];
-        node.info.cost = info.weight;
-        
-        pq.push(&node);
-        node.info.path.push_back(_startNode);
+      m_ReverseEdges[back].weight = weight;
+      break;
     }
+  }
 
-    // Dijkstra's algorithm execution
-    while (!pq.empty()) 
-    {
-        GNode* current = pq.top(); 
-        pq.pop();
-        
-        current->m_Evaluated = true;
-        current->info.path.push_back(current->m_id);
-        
-        const auto &adj_list = GetAdjList(current->m_id);
-
-        for (const auto& info : GetAdjList(current->m_id)) 
-        {
-            auto &neighbour = nodes[info.id - 1];
-            unsigned newCost = info.weight + current->info.cost;
-            
-            // Relaxation step: update neighbour's cost and path if a shorter path is found
-            if (newCost < neighbour.info.cost)
-            {
-                neighbour.info.cost = newCost;
-                neighbour.info.path = current->info.path; // Copy path from current to neighbour
-                if (!current->m_Evaluated)
-                  neighbour.info.path.push_back(current->m_id); // Append neighbour's own ID
-                pq.push(&neighbour); // Reinsert neighbour for further consideration
-            }
-        }
+  m_MinWeight = std::min(m_MinWeight, weight);
+  m_MaxWeight = std::max(m_MaxWeight, weight);
+  DropHierarchy();
+  return true;
+}
+
+/**
+ * Remove an edge
+ * Of several edges between the same two nodes, the lightest is removed. A
+ * frozen graph stays frozen, but the edges after it in the packed arrays
+ * have to move, so this takes time proportional to the graph. A contraction
+ * hierarchy is dropped.
+ * @param source The 1-based source node
+ * @param destination The 1-based destination node
+ * @return False if there is no such edge
+ * @throw std::out_of_range if a node is not in the graph
+ */
+bool ALGraph::RemoveEdge(unsigned source, unsigned destination)
+{
+  const unsigned size = Size();
+  if (source < 1 || source > size || destination < 1 || destination > size)
+    throw std::out_of_range("ALGraph::RemoveEdge: node out of range");
+
+  if (!m_Frozen)
+  {
+    auto &list = m_AdjacencyList[source - 1];
+    for (auto it = list.begin(); it != list.end(); ++it)
+    {
+      if (it->id == destination)
+      {
+        list.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const unsigned s = source - 1, d = destination - 1;
+  unsigned at = m_Offsets[s];
+  while (at < m_Offsets[s + 1] && m_Edges[at].to != d)
+    ++at;
+  if (at == m_Offsets[s + 1])
+    return false;
+  const unsigned oldWeight = m_Edges[at].weight;
+
+  m_Edges.erase(m_Edges.begin() + at);
+  for (unsigned node = s + 1; node <= size; ++node)
+    --m_Offsets[node];
+
+  for (unsigned back = m_ReverseOffsets[d]; back < m_ReverseOffsets[d + 1]; ++back)
+  {
+    if (m_ReverseEdges[back].to == s && m_ReverseEdges[back].weight == oldWeight)
+    {
+      m_ReverseEdges.erase(m_ReverseEdges.begin() + back);
+      for (unsigned node = d + 1; node <= size; ++node)
+        --m_ReverseOffsets[node];
+      break;
     }
+  }
+
+  DropHierarchy();
+  return true;
+}
+
+/**
+ * Constructor for the NodeHeap class
+ * @param size The number of nodes that can be in the heap
+ */
+ALGraph::NodeHeap::NodeHeap(unsigned size)
+  : m_Slot(size, static_cast<unsigned>(-1)), m_Cost(size, static_cast<unsigned>(-1))
+{
+  m_Heap.reserve(size);
+}
+
+/**
+ * Check if the heap is empty
+ * @return True if no node is in the heap
+ */
+bool ALGraph::NodeHeap::Empty(void) const
+{
+  return m_Heap.empty();
+}
+
+/**
+ * Get the cost of the cheapest node
+ * @return The cost, or INF if the heap is empty
+ */
+unsigned ALGraph::NodeHeap::TopCost(void) const
+{
+  return m_Heap.empty() ? static_cast<unsigned>(-1) : m_Cost[m_Heap.front()];
+}
+
+/**
+ * Remove every node, in time proportional to the nodes in the heap
+ */
+void ALGraph::NodeHeap::Clear(void)
+{
+  for (unsigned node : m_Heap)
+    m_Slot[node] = static_cast<unsigned>(-1);
+  m_Heap.clear();
+}
+
+/**
+ * Insert a node, or lower its cost if it is already in the heap
+ * @param node The 0-based node index
+ * @param cost The new cost, not higher than the current one
+ */
+void ALGraph::NodeHeap::Push(unsigned node, unsigned cost)
+{
+  m_Cost[node] = cost;
+  if (m_Slot[node] == static_cast<unsigned>(-1))
+  {
+    m_Heap.push_back(node);
+    m_Slot[node] = static_cast<unsigned>(m_Heap.size() - 1);
+  }
+  SiftUp(m_Slot[node]);
+}
+
+/**
+ * Remove the cheapest node, the one with the lower index on ties
+ * @return The 0-based index of the removed node
+ */
+unsigned ALGraph::NodeHeap::Pop(void)
+{
+  unsigned top = m_Heap.front();
+  unsigned last = m_Heap.back();
+  m_Heap.pop_back();
+  m_Slot[top] = static_cast<unsigned>(-1);
+
+  if (!m_Heap.empty())
+  {
+    Place(0, last);
+    SiftDown(0);
+  }
+  return top;
+}
+
+/**
+ * Compare two nodes by cost, then by index
+ * @param a One node
+ * @param b The other node
+ * @return True if a comes out of the heap before b
+ */
+bool ALGraph::NodeHeap::Less(unsigned a, unsigned b) const
+{
+  return m_Cost[a] < m_Cost[b] || (m_Cost[a] == m_Cost[b] && a < b);
+}
+
+/**
+ * Move the node in a slot up until its parent is cheaper
+ * @param slot The position in the heap
+ */
+void ALGraph::NodeHeap::SiftUp(unsigned slot)
+{
+  unsigned node = m_Heap[slot];
+  while (slot > 0)
+  {
+    unsigned parent = (slot - 1) / 2;
+    if (!Less(node, m_Heap[parent]))
+      break;
+    Place(slot, m_Heap[parent]);
+    slot = parent;
+  }
+  Place(slot, node);
+}
+
+/**
+ * Move the node in a slot down until both children are dearer
+ * @param slot The position in the heap
+ */
+void ALGraph::NodeHeap::SiftDown(unsigned slot)
+{
+  unsigned node = m_Heap[slot];
+  unsigned size = static_cast<unsigned>(m_Heap.size());
+  for (;;)
+  {
+    unsigned child = 2 * slot + 1;
+    if (child >= size)
+      break;
+    if (child + 1 < size && Less(m_Heap[child + 1], m_Heap[child]))
+      ++child;
+    if (!Less(m_Heap[child], node))
+      break;
+    Place(slot, m_Heap[child]);
+    slot = child;
+  }
+  Place(slot, node);
+}
+
+/**
+ * Put a node into a slot and remember where it is
+ * @param slot The position in the heap
+ * @param node The 0-based node index
+ */
+void ALGraph::NodeHeap::Place(unsigned slot, unsigned node)
+{
+  m_Heap[slot] = node;
+  m_Slot[node] = slot;
+}
+
+/**
+ * Constructor for the SearchSpace struct
+ */
+ALGraph::SearchSpace::SearchSpace(void) : heap(0)
+{
+}
+
+/**
+ * Make room for a graph of the given size
+ * @param size The number of nodes in the graph
+ */
+void ALGraph::SearchSpace::Prepare(unsigned size)
+{
+  if (cost.size() >= size)
+    return;
+
+  cost.assign(size, static_cast<unsigned>(-1));
+  previous.assign(size, static_cast<unsigned>(-1));
+  heap = NodeHeap(size);
+}
+
+/**
+ * Record a better cost for a node
+ * @param node The 0-based node index
+ * @param newCost The new cost
+ * @param from The node it was reached from
+ */
+void ALGraph::SearchSpace::Label(unsigned node, unsigned newCost, unsigned from)
+{
+  if (cost[node] == static_cast<unsigned>(-1))
+    touched.push_back(node); // First time reached
+  cost[node] = newCost;
+  previous[node] = from;
+}
+
+/**
+ * Undo the labels of the last query
+ */
+void ALGraph::SearchSpace::Reset(void)
+{
+  for (unsigned node : touched)
+  {
+    cost[node] = static_cast<unsigned>(-1);
+    previous[node] = static_cast<unsigned>(-1);
+  }
+  touched.clear();
+  heap.Clear();
+}
+
+/**
+ * Constructor for the BucketQueue class
+ * @param maxWeight The heaviest edge of the graph
+ */
+ALGraph::BucketQueue::BucketQueue(unsigned maxWeight)
+  : m_Buckets(static_cast<size_t>(maxWeight) + 1), m_Current(0), m_Count(0), m_Sorted(true)
+{
+}
+
+/**
+ * Check if the queue is empty
+ * @return True if no node is in the queue
+ */
+bool ALGraph::BucketQueue::Empty(void) const
+{
+  return m_Count == 0;
+}
+
+/**
+ * Get the cost of the cheapest node
+ * @return The cost, or INF if the queue is empty
+ */
+unsigned ALGraph::BucketQueue::TopCost(void) const
+{
+  return m_Count == 0 ? static_cast<unsigned>(-1) : m_Current;
+}
+
+/**
+ * Insert a node
+ * Costs below the current one only come right after the queue ran empty,
+ * from the node just taken, and all of them are within maxWeight of it.
+ * @param node The 0-based node index
+ * @param cost Its cost, not below the last one taken and at most maxWeight above
+ */
+void ALGraph::BucketQueue::Push(unsigned node, unsigned cost)
+{
+  if (m_Count == 0 || cost < m_Current)
+    m_Current = cost;
+  if (cost == m_Current)
+    m_Sorted = false;
+  m_Buckets[cost % m_Buckets.size()].push_back(node);
+  ++m_Count;
+}
+
+/**
+ * Remove the cheapest node, the one with the lower index on ties
+ * @return The 0-based index of the removed node
+ */
+unsigned ALGraph::BucketQueue::Pop(void)
+{
+  std::vector<unsigned> &bucket = m_Buckets[m_Current % m_Buckets.size()];
+  if (!m_Sorted) // Taken from the back, so the lowest index goes last
+  {
+    std::sort(bucket.begin(), bucket.end(), std::greater<unsigned>());
+    m_Sorted = true;
+  }
+  unsigned node = bucket.back();
+  bucket.pop_back();
+  if (--m_Count != 0 && bucket.empty())
+    Advance();
+  return node;
+}
+
+/**
+ * Move on to the next bucket that has nodes
+ */
+void ALGraph::BucketQueue::Advance(void)
+{
+  do
+    ++m_Current;
+  while (m_Buckets[m_Current % m_Buckets.size()].empty());
+  m_Sorted = false;
+}
+
+/**
+ * Constructor for the SearchQueues struct
+ * @param graph The graph that will be searched
+ */
+ALGraph::SearchQueues::SearchQueues(const ALGraph &graph)
+  : kind(graph.PickQueue()),
+    heap(kind == BINARY_HEAP ? graph.Size() : 0),
+    buckets(kind == BUCKET_QUEUE ? graph.m_MaxWeight : 0)
+{
+}
+
+/**
+ * Perform Dijkstra's algorithm on the graph
+ * Only the predecessor of each node is recorded during the search and the
+ * paths are built at the end.
+ * @param _startNode The starting node for the algorithm
+ * @return A vector of DijkstraInfo structs, one for each node in the graph
+ */
+std::vector<DijkstraInfo> ALGraph::Dijkstra(unsigned _startNode) const 
+{
+    const unsigned size = Size();
+    std::vector<unsigned> cost(size), previous(size);
+    SearchQueues queues(*this);
+    ShortestPaths(_startNode - 1, cost.data(), previous.data(), queues);
 
-    // Construct result from nodes' Dijkstra information
-    for (unsigned i = 0; i < nodes.size(); ++i)
+    // Construct result by walking the predecessors back to the start
+    std::vector<DijkstraInfo> dijkstraResults(size);
+    for (unsigned i = 0; i < size; ++i)
     {
-        dijkstraResults.push_back(nodes.at(i).info);
+        DijkstraInfo &info = dijkstraResults[i];
+        info.cost = cost[i];
+        if (cost[i] == INF) // Unreachable nodes have no path
+            continue;
+
+        for (unsigned node = i; node != INF; node = previous[node])
+            info.path.push_back(node + 1); // Adjust for 1-based indexing
+        std::reverse(info.path.begin(), info.path.end());
     }
 
     return dijkstraResults;
 }
 
 /**
- * Get the adjacency list representation of the graph
- * @return The adjacency list
+ * Perform Dijkstra's algorithm on the graph without building the paths
+ * @param _startNode The starting node for the algorithm
+ * @return The cost to reach each node, INF for unreachable nodes
  */
-ALIST ALGraph::GetAList() const
+std::vector<unsigned> ALGraph::DijkstraCosts(unsigned _startNode) const
+{
+    const unsigned size = Size();
+    std::vector<unsigned> cost(size);
+    SearchQueues queues(*this);
+    ShortestPaths(_startNode - 1, cost.data(), nullptr, queues);
+    return cost;
+}
+
+/**
+ * Perform Dijkstra's algorithm from many starting nodes at once
+ * The sources are handed out one at a time to a pool of threads. Each thread
+ * has its own queues, made before the threads start and reused from one
+ * source to the next, and writes straight into its rows of the result.
+ * @param sources The starting nodes, 1-based
+ * @param predecessors Whether to fill DistanceMatrix::previous too
+ * @param threads The number of threads, 0 for one per hardware thread
+ * @return The cost (and predecessor) of every node from every source
+ * @throw std::out_of_range if a source is not in the graph
+ */
+DistanceMatrix ALGraph::DijkstraMany(const std::vector<unsigned> &sources, bool predecessors,
+                                     unsigned threads) const
 {
-  return m_AdjacencyList;
+    const unsigned size = Size();
+    for (unsigned source : sources)
+    {
+        if (source < 1 || source > size)
+            throw std::out_of_range("ALGraph::DijkstraMany: source out of range");
+    }
+
+    DistanceMatrix matrix;
+    matrix.sources = static_cast<unsigned>(sources.size());
+    matrix.nodes = size;
+    matrix.cost.resize(static_cast<size_t>(matrix.sources) * size);
+    if (predecessors)
+        matrix.previous.resize(matrix.cost.size());
+
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max(1u, std::min(threads, matrix.sources));
+
+    std::vector<SearchQueues> queues(threads, SearchQueues(*this));
+    std::atomic<unsigned> nextRow(0);
+
+    // Each worker takes the next unclaimed source until none are left
+    auto worker = [&](unsigned id)
+    {
+        for (unsigned row = nextRow++; row < matrix.sources; row = nextRow++)
+        {
+            unsigned *cost = matrix.cost.data() + static_cast<size_t>(row) * size;
+            unsigned *previous = predecessors ? matrix.previous.data() + static_cast<size_t>(row) * size : nullptr;
+            ShortestPaths(sources[row] - 1, cost, previous, queues[id]);
+
+            if (previous) // Switch to 1-based ids, 0 for none
+            {
+                for (unsigned node = 0; node < size; ++node)
+                    previous[node] = previous[node] == INF ? 0 : previous[node] + 1;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned id = 1; id < threads; ++id)
+    {
+        try
+        {
+            pool.emplace_back(worker, id);
+        }
+        catch (const std::system_error &) // Out of threads, the others do its share
+        {
+            break;
+        }
+    }
+    worker(0); // The calling thread works too
+    for (std::thread &thread : pool)
+        thread.join();
+
+    return matrix;
 }
 
 /**
- * Less than operator for GNode
- * @param rhs The right-hand side of the comparison
- * @return True if the left-hand side is less than the right-hand side
+ * Perform a parallel single source search with delta-stepping
+ * Nodes are kept in buckets of width delta by their current cost. The
+ * cheapest bucket is emptied in rounds: the worker threads relax the light
+ * edges (weight <= delta) of all its nodes at once, which may refill it,
+ * and once it stays empty the heavy edges of every node that was in it are
+ * relaxed. Costs are lowered with compare-and-swap, so the threads need no
+ * locks. A delta of 1 behaves like Dijkstra, a huge delta like Bellman-Ford.
+ * @param _startNode The starting node for the algorithm
+ * @param delta The bucket width, 0 to use the largest weight divided by the
+ *              average number of edges per node
+ * @param threads The number of threads, 0 for one per hardware thread
+ * @return The cost to reach each node, the same as DijkstraCosts
+ * @throw std::out_of_range if the start is not in the graph
  */
-bool ALGraph::GNode::operator<(const GNode &rhs) const
+std::vector<unsigned> ALGraph::DeltaStepping(unsigned _startNode, unsigned delta, unsigned threads) const
 {
-  return info.cost < rhs.info.cost;
-}
\ No newline at end of file
+    const unsigned size = Size();
+    if (_startNode < 1 || _startNode > size)
+        throw std::out_of_range("ALGraph::DeltaStepping: start out of range");
+
+    unsigned maxWeight = 0;
+    unsigned long long edges = 0;
+    for (unsigned node = 0; node < size; ++node)
+    {
+        ForEachEdge(node, [&](unsigned, unsigned weight)
+        {
+            maxWeight = std::max(maxWeight, weight);
+            ++edges;
+        });
+    }
+    if (delta == 0)
+        delta = std::max(1u, static_cast<unsigned>(maxWeight * static_cast<unsigned long long>(size) / std::max(1ull, edges)));
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Every pending cost is within maxWeight of the current bucket, so the
+    // buckets can be reused in a ring
+    const size_t ringSize = maxWeight / delta + 2;
+    std::vector<std::vector<unsigned>> buckets(ringSize);
+    std::vector<std::atomic<unsigned>> cost(size);
+    for (std::atomic<unsigned> &c : cost)
+        c.store(INF, std::memory_order_relaxed);
+
+    // Nodes whose cost was lowered, collected by each thread and then bucketed
+    std::vector<std::vector<unsigned>> lowered(threads);
+    auto bucketLowered = [&]()
+    {
+        for (std::vector<unsigned> &list : lowered)
+        {
+            for (unsigned node : list)
+                buckets[cost[node].load(std::memory_order_relaxed) / delta % ringSize].push_back(node);
+            list.clear();
+        }
+    };
+
+    // The nodes of the current round and which edges to relax
+    std::vector<unsigned> round;
+    bool heavy = false;
+    bool finished = false;
+    std::atomic<size_t> nextChunk(0);
+    const size_t CHUNK = 256;
+
+    auto work = [&](unsigned id)
+    {
+        for (size_t begin = nextChunk.fetch_add(CHUNK); begin < round.size(); begin = nextChunk.fetch_add(CHUNK))
+        {
+            size_t end = std::min(begin + CHUNK, round.size());
+            for (size_t i = begin; i < end; ++i)
+            {
+                unsigned current = round[i];
+                unsigned currentCost = cost[current].load(std::memory_order_relaxed);
+                ForEachEdge(current, [&](unsigned neighbour, unsigned weight)
+                {
+                    if ((weight > delta) != heavy)
+                        return;
+
+                    // Lower the neighbour's cost unless another thread got it lower
+                    unsigned newCost = currentCost + weight;
+                    unsigned old = cost[neighbour].load(std::memory_order_relaxed);
+                    while (newCost < old)
+                    {
+                        if (cost[neighbour].compare_exchange_weak(old, newCost, std::memory_order_relaxed))
+                        {
+                            lowered[id].push_back(neighbour);
+                            break;
+                        }
+                    }
+                });
+            }
+        }
+    };
+
+    // Helper threads run every round together with the calling thread
+    PhaseBarrier barrier(threads);
+    auto helper = [&](unsigned id)
+    {
+        for (;;)
+        {
+            barrier.Wait(); // Round ready
+            if (finished)
+                return;
+            work(id);
+            barrier.Wait(); // Round done
+        }
+    };
+    auto runRound = [&]()
+    {
+        nextChunk = 0;
+        if (threads > 1)
+            barrier.Wait();
+        work(0);
+        if (threads > 1)
+            barrier.Wait();
+        bucketLowered();
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned id = 1; id < threads; ++id)
+    {
+        try
+        {
+            pool.emplace_back(helper, id);
+        }
+        catch (const std::system_error &) // Out of threads, go on with fewer
+        {
+            threads = id;
+            barrier.Resize(threads);
+            break;
+        }
+    }
+
+    cost[_startNode - 1] = 0;
+    buckets[0].push_back(_startNode - 1);
+
+    // Which round and which bucket each node was last taken in, to skip duplicates
+    std::vector<unsigned> inRound(size, INF), inBucket(size, INF);
+    std::vector<unsigned> bucketNodes;
+    unsigned roundNumber = 0;
+    size_t empty = 0;
+
+    for (unsigned bucket = 0; empty < ringSize; ++bucket)
+    {
+        std::vector<unsigned> &slot = buckets[bucket % ringSize];
+        if (slot.empty())
+        {
+            ++empty;
+            continue;
+        }
+        empty = 0;
+
+        bucketNodes.clear();
+        while (!slot.empty())
+        {
+            // Take the nodes that still belong here, once each
+            round.clear();
+            for (unsigned node : slot)
+            {
+                if (cost[node].load(std::memory_order_relaxed) / delta != bucket || inRound[node] == roundNumber)
+                    continue;
+                inRound[node] = roundNumber;
+                round.push_back(node);
+                if (inBucket[node] != bucket)
+                {
+                    inBucket[node] = bucket;
+                    bucketNodes.push_back(node);
+                }
+            }
+            slot.clear();
+            ++roundNumber;
+
+            heavy = false;
+            runRound();
+        }
+
+        round.swap(bucketNodes);
+        heavy = true;
+        runRound();
+    }
+
+    finished = true;
+    if (threads > 1)
+        barrier.Wait();
+    for (std::thread &thread : pool)
+        thread.join();
+
+    std::vector<unsigned> result(size);
+    for (unsigned node = 0; node < size; ++node)
+        result[node] = cost[node].load(std::memory_order_relaxed);
+    return result;
+}
+
+/**
+ * Pick the queue for Dijkstra from the edge weights
+ * Integer costs only grow during a search, so with small weights Dial's
+ * bucket queue can stand in for the binary heap, in O(E + V * maxWeight)
+ * time instead of O(E log V). It settles nodes of equal cost in index order
+ * like the heap, which the paths depend on, by sorting them when their cost
+ * comes up. The binary heap is kept for heavy edges, for graphs with fewer
+ * nodes than buckets, and for edges of weight 0, since every node pushed at
+ * the current cost would make the bucket sort again.
+ * @return The queue to use
+ */
+ALGraph::QueueKind ALGraph::PickQueue(void) const
+{
+  const unsigned DIAL_LIMIT = 1 << 12; // Heaviest edge for a ring of buckets
+
+  if (m_MinWeight == 0 || m_MaxWeight > DIAL_LIMIT || m_MaxWeight > Size())
+    return BINARY_HEAP;
+  return BUCKET_QUEUE;
+}
+
+/**
+ * Find the shortest paths from one node to all others
+ * The queue is picked by PickQueue.
+ * @param start The 0-based starting node
+ * @param cost Filled with the cost to reach each node, INF if unreachable
+ * @param previous Filled with the node before each node on its path, INF for
+ *                 the start and unreachable nodes; may be nullptr
+ * @param queues Queues made for this graph, all empty again afterwards
+ * @throw std::out_of_range if the start is not in the graph
+ */
+void ALGraph::ShortestPaths(unsigned start, unsigned *cost, unsigned *previous,
+                            SearchQueues &queues) const
+{
+    const unsigned size = Size();
+    if (start >= size)
+        throw std::out_of_range("ALGraph::ShortestPaths: start out of range");
+
+    std::fill(cost, cost + size, INF);
+    if (previous)
+        std::fill(previous, previous + size, INF);
+
+    if (queues.kind == BUCKET_QUEUE)
+        Settle(start, cost, previous, queues.buckets);
+    else
+        Settle(start, cost, previous, queues.heap);
+}
+
+/**
+ * Run Dijkstra's algorithm with a given queue
+ * A queue may hold a node more than once; an entry whose cost is above the
+ * node's cost is left over from before the node got cheaper and is skipped.
+ * @param start The 0-based starting node
+ * @param cost The cost of each node, INF except for the ones to find
+ * @param previous The node before each node on its path, may be nullptr
+ * @param queue An empty queue, empty again afterwards
+ */
+template <typename Queue>
+void ALGraph::Settle(unsigned start, unsigned *cost, unsigned *previous, Queue &queue) const
+{
+    cost[start] = 0;
+    queue.Push(start, 0);
+
+    // Dijkstra's algorithm execution
+    while (!queue.Empty()) 
+    {
+        unsigned key = queue.TopCost();
+        unsigned current = queue.Pop();
+        if (key != cost[current])
+            continue; // Its cost is final already
+
+        ForEachEdge(current, [&](unsigned neighbour, unsigned weight)
+        {
+            unsigned newCost = cost[current] + weight;
+
+            // Relaxation step: update neighbour's cost and predecessor if a shorter path is found
+            if (newCost < cost[neighbour])
+            {
+                cost[neighbour] = newCost;
+                if (previous)
+                    previous[neighbour] = current;
+                queue.Push(neighbour, newCost); // Inserts it, or lowers its cost in a NodeHeap
+            }
+        });
+    }
+}
+
+/**
+ * Find the shortest path between two nodes with a bidirectional search
+ * One search runs forward from the source and one backward from the target,
+ * always advancing the one with the cheaper next node. Every edge that
+ * reaches a node labelled by the other search is a candidate path, and the
+ * searches stop once the two next nodes together cost at least as much as
+ * the best candidate. A graph that is not frozen has no reversed edges, so
+ * a single forward search is used and stops when the target is settled.
+ * A contracted graph answers from its hierarchy instead; see Contract.
+ * Ties between paths of equal cost may be broken differently from Dijkstra.
+ * @param source The 1-based starting node
+ * @param target The 1-based destination node
+ * @param settled If given, set to the number of nodes settled by the query
+ * @return The cost and path, INF and no path if the target is unreachable
+ * @throw std::out_of_range if either node is not in the graph
+ */
+DijkstraInfo ALGraph::ShortestPath(unsigned source, unsigned target, unsigned *settled) const
+{
+    if (!m_Frozen)
+        return SearchTo(source, target, nullptr, settled);
+
+    const unsigned size = Size();
+    if (source < 1 || source > size || target < 1 || target > size)
+        throw std::out_of_range("ALGraph::ShortestPath: node out of range");
+
+    // Scratch buffers of this thread, reset after every query
+    static thread_local SearchSpace forward, backward;
+    forward.Prepare(size);
+    backward.Prepare(size);
+
+    const unsigned s = source - 1, t = target - 1;
+    unsigned best = (s == t) ? 0 : INF;  // Cost of the best path found so far
+    unsigned meetFrom = s, meetTo = s;   // Its edge from the forward side to the backward side
+    unsigned count = 0;
+
+    DijkstraInfo result;
+    try
+    {
+        if (IsContracted())
+        {
+            result = HierarchyPath(source, target, forward, backward, settled);
+            forward.Reset();
+            backward.Reset();
+            return result;
+        }
+
+        forward.Label(s, 0, INF);
+        forward.heap.Push(s, 0);
+        backward.Label(t, 0, INF);
+        backward.heap.Push(t, 0);
+
+        for (;;)
+        {
+            unsigned topForward = forward.heap.TopCost();
+            unsigned topBackward = backward.heap.TopCost();
+            if (topForward == INF || topBackward == INF)
+                break; // One side ran out, nothing more can be found
+            if (static_cast<unsigned long long>(topForward) + topBackward >= best)
+                break; // No path through an unsettled node can be cheaper
+
+            bool isForward = topForward <= topBackward;
+            SearchSpace &self = isForward ? forward : backward;
+            SearchSpace &other = isForward ? backward : forward;
+            unsigned current = self.heap.Pop();
+            ++count;
+
+            auto relax = [&](unsigned neighbour, unsigned weight)
+            {
+                unsigned newCost = self.cost[current] + weight;
+                if (newCost < self.cost[neighbour])
+                {
+                    self.Label(neighbour, newCost, current);
+                    self.heap.Push(neighbour, newCost);
+                }
+
+                // A path through this edge, if the other side has reached it
+                if (other.cost[neighbour] != INF &&
+                    static_cast<unsigned long long>(newCost) + other.cost[neighbour] < best)
+                {
+                    best = newCost + other.cost[neighbour];
+                    meetFrom = isForward ? current : neighbour;
+                    meetTo = isForward ? neighbour : current;
+                }
+            };
+            if (isForward)
+                ForEachEdge(current, relax);
+            else
+                ForEachInEdge(current, relax);
+        }
+    }
+    catch (...) // Leave the buffers clean for the next query
+    {
+        forward.Reset();
+        backward.Reset();
+        throw;
+    }
+
+    result = MakePath(forward, &backward, meetFrom, meetTo, best);
+    forward.Reset();
+    backward.Reset();
+    if (settled)
+        *settled = count;
+    return result;
+}
+
+/**
+ * Find the shortest path between two nodes with an A* search
+ * Nodes are taken in order of their cost plus the heuristic's estimate of
+ * the rest of the way, so nodes leading away from the target are rarely
+ * settled. The search stops when the target is taken. The heuristic must
+ * never overestimate; if it is not also consistent, nodes may be taken more
+ * than once.
+ * @param source The 1-based starting node
+ * @param target The 1-based destination node
+ * @param heuristic Lower bound on the cost from a 1-based node to the target
+ * @param settled If given, set to the number of nodes settled by the query
+ * @return The cost and path, INF and no path if the target is unreachable
+ * @throw std::out_of_range if either node is not in the graph
+ */
+DijkstraInfo ALGraph::ShortestPath(unsigned source, unsigned target, const Heuristic &heuristic,
+                                   unsigned *settled) const
+{
+    return SearchTo(source, target, &heuristic, settled);
+}
+
+/**
+ * Search forward from the source until the target is settled
+ * @param source The 1-based starting node
+ * @param target The 1-based destination node
+ * @param heuristic The A* estimate, or nullptr for a plain Dijkstra search
+ * @param settled If given, set to the number of nodes settled by the query
+ * @return The cost and path, INF and no path if the target is unreachable
+ */
+DijkstraInfo ALGraph::SearchTo(unsigned source, unsigned target, const Heuristic *heuristic,
+                               unsigned *settled) const
+{
+    const unsigned size = Size();
+    if (source < 1 || source > size || target < 1 || target > size)
+        throw std::out_of_range("ALGraph::ShortestPath: node out of range");
+
+    static thread_local SearchSpace space;
+    space.Prepare(size);
+
+    // Cost so far plus the estimate of the rest, without overflowing
+    auto key = [&](unsigned node, unsigned cost)
+    {
+        unsigned estimate = heuristic ? (*heuristic)(node + 1) : 0;
+        return estimate >= INF - cost ? INF - 1 : cost + estimate;
+    };
+
+    const unsigned s = source - 1, t = target - 1;
+    unsigned count = 0;
+    try
+    {
+        space.Label(s, 0, INF);
+        space.heap.Push(s, key(s, 0));
+
+        while (!space.heap.Empty())
+        {
+            unsigned current = space.heap.Pop();
+            ++count;
+            if (current == t) // Its cost is final now
+                break;
+
+            ForEachEdge(current, [&](unsigned neighbour, unsigned weight)
+            {
+                unsigned newCost = space.cost[current] + weight;
+                if (newCost < space.cost[neighbour])
+                {
+                    space.Label(neighbour, newCost, current);
+                    space.heap.Push(neighbour, key(neighbour, newCost)); // May reopen a settled node
+                }
+            });
+        }
+    }
+    catch (...) // The heuristic may throw; leave the buffers clean for the next query
+    {
+        space.Reset();
+        throw;
+    }
+
+    DijkstraInfo result = MakePath(space, nullptr, t, t, space.cost[t]);
+    space.Reset();
+    if (settled)
+        *settled = count;
+    return result;
+}
+
+/**
+ * Build the path of a point-to-point query
+ * The path follows the forward predecessors back from one end of the meeting
+ * edge and the backward ones on from its other end.
+ * @param forward The labels of the forward search
+ * @param backward The labels of the backward search, or nullptr
+ * @param from The 0-based node on the forward side of the meeting edge
+ * @param to The 0-based node on the backward side; equal to from if there is
+ *           no backward search or the searches met in a node
+ * @param cost The cost of the path, INF if there is none
+ * @return The cost and path
+ */
+DijkstraInfo ALGraph::MakePath(const SearchSpace &forward, const SearchSpace *backward,
+                               unsigned from, unsigned to, unsigned cost) const
+{
+    DijkstraInfo info;
+    info.cost = cost;
+    if (cost == INF)
+        return info;
+
+    for (unsigned node = from; node != INF; node = forward.previous[node])
+        info.path.push_back(node + 1); // Adjust for 1-based indexing
+    std::reverse(info.path.begin(), info.path.end());
+
+    if (backward)
+    {
+        unsigned node = (to == from) ? backward->previous[to] : to;
+        for (; node != INF; node = backward->previous[node])
+            info.path.push_back(node + 1);
+    }
+    return info;
+}
+
+/**
+ * Builds a contraction hierarchy
+ * Nodes are taken out of the graph one at a time, cheapest first by their
+ * edge difference (the shortcuts their removal needs minus the edges it
+ * removes) and the neighbours already removed, so the order spreads over the
+ * graph. A shortcut joins two neighbours of the removed node unless a
+ * bounded witness search finds another path that is no longer. The edges a
+ * node still has when it is removed all lead to nodes of higher rank.
+ */
+class ALGraph::Contraction
+{
+public:
+  /**
+   * Copy the edges of a graph, keeping the cheapest of parallel edges
+   * @param graph The graph to contract
+   */
+  Contraction(const ALGraph &graph)
+    : m_Out(graph.Size()), m_In(graph.Size()), m_Removed(graph.Size(), 0)
+  {
+    m_Witness.Prepare(graph.Size());
+    for (unsigned node = 0; node < graph.Size(); ++node)
+    {
+      graph.ForEachEdge(node, [&](unsigned neighbour, unsigned weight)
+      {
+        if (neighbour != node) // Loops are never on a shortest path
+          AddArc(node, neighbour, weight, NONE);
+      });
+    }
+  }
+
+  /**
+   * Contract every node and store the hierarchy in the graph
+   * @param graph The graph the edges were copied from
+   */
+  void Run(ALGraph &graph)
+  {
+    const unsigned size = static_cast<unsigned>(m_Out.size());
+    std::vector<std::vector<HierarchyEdge>> up(size), down(size);
+    std::vector<unsigned> rank(size);
+
+    NodeHeap queue(size);
+    for (unsigned node = 0; node < size; ++node)
+      queue.Push(node, Priority(node));
+
+    for (unsigned next = 0; next < size; ++next)
+    {
+      // Priorities go stale as neighbours are removed; take a node only if
+      // its current priority still comes first
+      unsigned node = queue.Pop();
+      unsigned priority = Priority(node);
+      while (!queue.Empty() && priority > queue.TopCost())
+      {
+        queue.Push(node, priority);
+        node = queue.Pop();
+        priority = Priority(node);
+      }
+
+      FindShortcuts(node, SETTLE_LIMIT);
+      rank[node] = next;
+      for (const Arc &arc : m_Out[node])
+      {
+        up[node].push_back(HierarchyEdge{arc.node, arc.weight, arc.middle});
+        RemoveArc(m_In[arc.node], node);
+        ++m_Removed[arc.node];
+      }
+      for (const Arc &arc : m_In[node])
+      {
+        down[node].push_back(HierarchyEdge{arc.node, arc.weight, arc.middle});
+        RemoveArc(m_Out[arc.node], node);
+        ++m_Removed[arc.node];
+      }
+      std::vector<Arc>().swap(m_Out[node]);
+      std::vector<Arc>().swap(m_In[node]);
+
+      for (const Shortcut &shortcut : m_Shortcuts)
+        AddArc(shortcut.from, shortcut.to, shortcut.weight, node);
+    }
+
+    graph.m_Rank.swap(rank);
+    Pack(up, graph.m_UpOffsets, graph.m_UpEdges);
+    Pack(down, graph.m_DownOffsets, graph.m_DownEdges);
+  }
+
+private:
+  static const unsigned NONE = static_cast<unsigned>(-1);
+  static const unsigned SETTLE_LIMIT = 500;   // Witness search size when contracting
+  static const unsigned ESTIMATE_LIMIT = 50;  // and when estimating a priority
+
+  // An edge between two nodes that are not contracted yet
+  struct Arc
+  {
+    unsigned node;   // the other end
+    unsigned weight;
+    unsigned middle; // the node a shortcut passes, NONE for an edge of the graph
+  };
+
+  struct Shortcut
+  {
+    unsigned from;
+    unsigned to;
+    unsigned weight;
+  };
+
+  /**
+   * Add an edge, or lower the weight of the one already there
+   * @param from The 0-based source
+   * @param to The 0-based destination
+   * @param weight The weight of the edge
+   * @param middle The node a shortcut passes, NONE for an edge of the graph
+   */
+  void AddArc(unsigned from, unsigned to, unsigned weight, unsigned middle)
+  {
+    for (Arc &arc : m_Out[from])
+    {
+      if (arc.node != to)
+        continue;
+      if (weight < arc.weight)
+      {
+        arc = Arc{to, weight, middle};
+        for (Arc &back : m_In[to])
+        {
+          if (back.node == from)
+            back = Arc{from, weight, middle};
+        }
+      }
+      return;
+    }
+    m_Out[from].push_back(Arc{to, weight, middle});
+    m_In[to].push_back(Arc{from, weight, middle});
+  }
+
+  /**
+   * Remove the edge to or from a node out of a list
+   * @param list The edges of the node at the other end
+   * @param node The 0-based node at this end
+   */
+  static void RemoveArc(std::vector<Arc> &list, unsigned node)
+  {
+    for (size_t i = 0; i < list.size(); ++i)
+    {
+      if (list[i].node == node)
+      {
+        list[i] = list.back();
+        list.pop_back();
+        return;
+      }
+    }
+  }
+
+  /**
+   * Find the shortcuts needed to contract a node, into m_Shortcuts
+   * @param node The 0-based node to contract
+   * @param limit The most nodes each witness search may settle
+   */
+  void FindShortcuts(unsigned node, unsigned limit)
+  {
+    m_Shortcuts.clear();
+    for (const Arc &in : m_In[node])
+    {
+      unsigned longest = 0;
+      bool through = false; // Whether a path leads through the node from here
+      for (const Arc &out : m_Out[node])
+      {
+        if (out.node != in.node)
+        {
+          longest = std::max(longest, in.weight + out.weight);
+          through = true;
+        }
+      }
+      if (!through)
+        continue;
+
+      Witness(in.node, node, longest, limit);
+      for (const Arc &out : m_Out[node])
+      {
+        if (out.node != in.node && m_Witness.cost[out.node] > in.weight + out.weight)
+          m_Shortcuts.push_back(Shortcut{in.node, out.node, in.weight + out.weight});
+      }
+      m_Witness.Reset();
+    }
+  }
+
+  /**
+   * Search for paths from a node that avoid the node being contracted
+   * @param source The 0-based start of the search
+   * @param avoid The 0-based node being contracted
+   * @param bound The search stops at nodes that cost more than this
+   * @param limit The most nodes the search may settle
+   */
+  void Witness(unsigned source, unsigned avoid, unsigned bound, unsigned limit)
+  {
+    m_Witness.Label(source, 0, NONE);
+    m_Witness.heap.Push(source, 0);
+    for (unsigned settled = 0; settled < limit && !m_Witness.heap.Empty(); ++settled)
+    {
+      if (m_Witness.heap.TopCost() > bound)
+        break;
+      unsigned current = m_Witness.heap.Pop();
+      for (const Arc &arc : m_Out[current])
+      {
+        unsigned newCost = m_Witness.cost[current] + arc.weight;
+        if (arc.node != avoid && newCost < m_Witness.cost[arc.node])
+        {
+          m_Witness.Label(arc.node, newCost, current);
+          m_Witness.heap.Push(arc.node, newCost);
+        }
+      }
+    }
+  }
+
+  /**
+   * Estimate how good a node is to contract next, lower is better
+   * @param node The 0-based node
+   * @return Twice the edge difference plus the contracted neighbours, made unsigned
+   */
+  unsigned Priority(unsigned node)
+  {
+    FindShortcuts(node, ESTIMATE_LIMIT);
+    long long difference = static_cast<long long>(m_Shortcuts.size())
+                         - static_cast<long long>(m_Out[node].size() + m_In[node].size());
+    long long priority = 2 * difference + m_Removed[node];
+    priority += 1u << 30; // Keep it above zero
+    return static_cast<unsigned>(std::min<long long>(std::max<long long>(priority, 0), NONE - 1));
+  }
+
+  /**
+   * Pack per-node edge lists into compressed sparse row form
+   * @param lists The edges of each node
+   * @param offsets Set to the offsets of each node's edges
+   * @param edges Set to all edges
+   */
+  static void Pack(const std::vector<std::vector<HierarchyEdge>> &lists,
+                   std::vector<unsigned> &offsets, std::vector<HierarchyEdge> &edges)
+  {
+    offsets.assign(1, 0);
+    edges.clear();
+    for (const auto &list : lists)
+    {
+      edges.insert(edges.end(), list.begin(), list.end());
+      offsets.push_back(static_cast<unsigned>(edges.size()));
+    }
+  }
+
+  std::vector<std::vector<Arc>> m_Out; // edges leaving each node, to nodes not contracted
+  std::vector<std::vector<Arc>> m_In;  // edges entering each node, from nodes not contracted
+  std::vector<unsigned> m_Removed;     // neighbours contracted so far
+  std::vector<Shortcut> m_Shortcuts;   // found by the last FindShortcuts
+  SearchSpace m_Witness;
+};
+
+/**
+ * Build a contraction hierarchy for fast point-to-point queries
+ * The graph is frozen, every node is contracted in turn (see Contraction)
+ * and the resulting edges and shortcuts are stored in compressed sparse row
+ * form. Afterwards ShortestPath answers from the hierarchy, searching only
+ * upwards from both ends. Adding an edge drops the hierarchy.
+ */
+void ALGraph::Contract(void)
+{
+  Freeze();
+  DropHierarchy();
+  Contraction contraction(*this);
+  contraction.Run(*this);
+}
+
+/**
+ * Check if the graph has a contraction hierarchy
+ * @return True after Contract or LoadHierarchy, until an edge is added
+ */
+bool ALGraph::IsContracted(void) const
+{
+  return !m_UpOffsets.empty();
+}
+
+/**
+ * Find the shortest path between two nodes in the contraction hierarchy
+ * Both searches only follow edges to nodes of higher rank, forward from the
+ * source and backward from the target, and every shortest path has a
+ * highest node where they meet. Each search stops once its next node costs
+ * at least as much as the best meeting found. The shortcuts on the path are
+ * then unpacked into the edges of the graph.
+ * @param source The 1-based starting node
+ * @param target The 1-based destination node
+ * @param forward Scratch labels for the forward search
+ * @param backward Scratch labels for the backward search
+ * @param settled If given, set to the number of nodes settled by the query
+ * @return The cost and path, INF and no path if the target is unreachable
+ */
+DijkstraInfo ALGraph::HierarchyPath(unsigned source, unsigned target, SearchSpace &forward,
+                                    SearchSpace &backward, unsigned *settled) const
+{
+    const unsigned s = source - 1, t = target - 1;
+    unsigned best = INF; // Cost of the best path found so far
+    unsigned meet = s;   // Its highest node
+    unsigned count = 0;
+
+    forward.Label(s, 0, INF);
+    forward.heap.Push(s, 0);
+    backward.Label(t, 0, INF);
+    backward.heap.Push(t, 0);
+
+    for (;;)
+    {
+        unsigned topForward = forward.heap.TopCost();
+        unsigned topBackward = backward.heap.TopCost();
+        if (topForward >= best)
+            topForward = INF; // This side cannot improve the path any more
+        if (topBackward >= best)
+            topBackward = INF;
+        if (topForward == INF && topBackward == INF)
+            break;
+
+        bool isForward = topForward <= topBackward;
+        SearchSpace &self = isForward ? forward : backward;
+        const SearchSpace &other = isForward ? backward : forward;
+        const std::vector<unsigned> &offsets = isForward ? m_UpOffsets : m_DownOffsets;
+        const std::vector<HierarchyEdge> &edges = isForward ? m_UpEdges : m_DownEdges;
+        unsigned current = self.heap.Pop();
+        ++count;
+
+        if (other.cost[current] != INF &&
+            static_cast<unsigned long long>(self.cost[current]) + other.cost[current] < best)
+        {
+            best = self.cost[current] + other.cost[current];
+            meet = current;
+        }
+
+        for (unsigned edge = offsets[current]; edge < offsets[current + 1]; ++edge)
+        {
+            unsigned neighbour = edges[edge].to;
+            unsigned newCost = self.cost[current] + edges[edge].weight;
+            if (newCost < self.cost[neighbour])
+            {
+                self.Label(neighbour, newCost, current);
+                self.heap.Push(neighbour, newCost);
+            }
+        }
+    }
+
+    DijkstraInfo info;
+    info.cost = best;
+    if (best != INF)
+    {
+        // Up from the source to the meeting node, then down to the target
+        std::vector<unsigned> nodes;
+        for (unsigned node = meet; node != INF; node = forward.previous[node])
+            nodes.push_back(node);
+        std::reverse(nodes.begin(), nodes.end());
+        for (unsigned node = backward.previous[meet]; node != INF; node = backward.previous[node])
+            nodes.push_back(node);
+
+        info.path.push_back(s + 1);
+        for (size_t i = 1; i < nodes.size(); ++i)
+            UnpackEdge(nodes[i - 1], nodes[i], info.path);
+    }
+    if (settled)
+        *settled = count;
+    return info;
+}
+
+/**
+ * Append the nodes of the graph that a hierarchy edge stands for
+ * A shortcut is replaced by its two halves until only edges of the graph
+ * are left. The edge between two nodes is kept with the lower ranked one.
+ * @param from The 0-based start of the edge
+ * @param to The 0-based end of the edge
+ * @param path Gets the 1-based nodes after from, up to and including to
+ */
+void ALGraph::UnpackEdge(unsigned from, unsigned to, std::vector<unsigned> &path) const
+{
+  std::vector<std::pair<unsigned, unsigned>> pending(1, std::make_pair(from, to));
+  while (!pending.empty())
+  {
+    unsigned a = pending.back().first, b = pending.back().second;
+    pending.pop_back();
+
+    unsigned middle = INF;
+    if (m_Rank[a] < m_Rank[b])
+    {
+      for (unsigned edge = m_UpOffsets[a]; edge < m_UpOffsets[a + 1]; ++edge)
+      {
+        if (m_UpEdges[edge].to == b)
+          middle = m_UpEdges[edge].middle;
+      }
+    }
+    else
+    {
+      for (unsigned edge = m_DownOffsets[b]; edge < m_DownOffsets[b + 1]; ++edge)
+      {
+        if (m_DownEdges[edge].to == a)
+          middle = m_DownEdges[edge].middle;
+      }
+    }
+
+    if (middle == INF)
+      path.push_back(b + 1);
+    else
+    {
+      pending.push_back(std::make_pair(middle, b)); // Second half after the first
+      pending.push_back(std::make_pair(a, middle));
+    }
+  }
+}
+
+/**
+ * Save the contraction hierarchy to a file
+ * @param filename The name of the file
+ * @return False if there is no hierarchy or the file cannot be written
+ */
+bool ALGraph::SaveHierarchy(const char *filename) const
+{
+  if (!IsContracted())
+    return false;
+  std::ofstream file(filename, std::ios::binary);
+  return file.is_open() && SaveHierarchy(file);
+}
+
+/**
+ * Save the contraction hierarchy to a binary stream
+ * The data is written in the byte order of this machine, after a header with
+ * the node count and a hash of the edges that LoadHierarchy checks, and is
+ * followed by a checksum of itself.
+ * @param stream The stream to write to
+ * @return False if there is no hierarchy or the stream failed
+ */
+bool ALGraph::SaveHierarchy(std::ostream &stream) const
+{
+  if (!IsContracted())
+    return false;
+
+  unsigned header[3] = {Size(), static_cast<unsigned>(m_UpEdges.size()),
+                        static_cast<unsigned>(m_DownEdges.size())};
+  unsigned long long hash = EdgeHash();
+  stream.write(HIERARCHY_MAGIC, sizeof(HIERARCHY_MAGIC));
+  stream.write(reinterpret_cast<const char *>(header), sizeof(header));
+  stream.write(reinterpret_cast<const char *>(&hash), sizeof(hash));
+  WriteArray(stream, m_Rank);
+  WriteArray(stream, m_UpOffsets);
+  WriteArray(stream, m_UpEdges);
+  WriteArray(stream, m_DownOffsets);
+  WriteArray(stream, m_DownEdges);
+
+  unsigned long long checksum = 0xCBF29CE484222325ull;
+  HashArray(checksum, m_Rank);
+  HashArray(checksum, m_UpOffsets);
+  HashArray(checksum, m_UpEdges);
+  HashArray(checksum, m_DownOffsets);
+  HashArray(checksum, m_DownEdges);
+  stream.write(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+  return static_cast<bool>(stream.flush());
+}
+
+/**
+ * Load a contraction hierarchy saved by SaveHierarchy
+ * @param filename The name of the file
+ * @return False if the file cannot be read or does not fit this graph
+ */
+bool ALGraph::LoadHierarchy(const char *filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  return file.is_open() && LoadHierarchy(file);
+}
+
+/**
+ * Load a contraction hierarchy saved by SaveHierarchy
+ * The graph is frozen. The hierarchy must have been built from a graph with
+ * the same nodes and edges, which is checked with a hash of the edges; a
+ * stream that fails the check or is damaged leaves the graph without one.
+ * The structure is checked as well, so that even a crafted stream cannot
+ * make a query read out of bounds.
+ * @param stream The stream to read from
+ * @return False if the stream cannot be read or does not fit this graph
+ */
+bool ALGraph::LoadHierarchy(std::istream &stream)
+{
+  Freeze();
+  DropHierarchy();
+
+  char magic[sizeof(HIERARCHY_MAGIC)];
+  unsigned header[3];
+  unsigned long long hash;
+  stream.read(magic, sizeof(magic));
+  stream.read(reinterpret_cast<char *>(header), sizeof(header));
+  stream.read(reinterpret_cast<char *>(&hash), sizeof(hash));
+  if (!stream || !std::equal(magic, magic + sizeof(magic), HIERARCHY_MAGIC) ||
+      header[0] != Size() || hash != EdgeHash())
+    return false;
+
+  // Read into local arrays, so the graph has no hierarchy until all is checked
+  const unsigned size = Size();
+  std::vector<unsigned> rank, upOffsets, downOffsets;
+  std::vector<HierarchyEdge> upEdges, downEdges;
+  bool ok = ReadArray(stream, rank, size) &&
+            ReadArray(stream, upOffsets, size + 1) &&
+            ReadArray(stream, upEdges, header[1]) &&
+            ReadArray(stream, downOffsets, size + 1) &&
+            ReadArray(stream, downEdges, header[2]);
+
+  unsigned long long checksum = 0xCBF29CE484222325ull, stored = 0;
+  HashArray(checksum, rank);
+  HashArray(checksum, upOffsets);
+  HashArray(checksum, upEdges);
+  HashArray(checksum, downOffsets);
+  HashArray(checksum, downEdges);
+  ok = ok && stream.read(reinterpret_cast<char *>(&stored), sizeof(stored)) && stored == checksum;
+
+  // Check everything a query relies on
+  std::vector<bool> seen(size, false);
+  for (unsigned node = 0; ok && node < size; ++node)
+  {
+    ok = rank[node] < size && !seen[rank[node]];
+    if (ok)
+      seen[rank[node]] = true;
+  }
+  for (int side = 0; ok && side < 2; ++side)
+  {
+    const std::vector<unsigned> &offsets = side ? downOffsets : upOffsets;
+    const std::vector<HierarchyEdge> &edges = side ? downEdges : upEdges;
+    ok = offsets[0] == 0 && offsets[size] == edges.size();
+    for (unsigned node = 0; ok && node < size; ++node)
+      ok = offsets[node] <= offsets[node + 1];
+    for (unsigned node = 0; ok && node < size; ++node)
+    {
+      for (unsigned edge = offsets[node]; ok && edge < offsets[node + 1]; ++edge)
+      {
+        const HierarchyEdge &info = edges[edge];
+        ok = info.to < size && rank[info.to] > rank[node] &&
+             (info.middle == INF || (info.middle < size && rank[info.middle] < rank[node]));
+      }
+    }
+  }
+
+  if (ok)
+  {
+    m_Rank.swap(rank);
+    m_UpOffsets.swap(upOffsets);
+    m_UpEdges.swap(upEdges);
+    m_DownOffsets.swap(downOffsets);
+    m_DownEdges.swap(downEdges);
+  }
+  return ok;
+}
+
+/**
+ * Release the contraction hierarchy
+ */
+void ALGraph::DropHierarchy(void)
+{
+  std::vector<unsigned>().swap(m_Rank);
+  std::vector<unsigned>().swap(m_UpOffsets);
+  std::vector<HierarchyEdge>().swap(m_UpEdges);
+  std::vector<unsigned>().swap(m_DownOffsets);
+  std::vector<HierarchyEdge>().swap(m_DownEdges);
+}
+
+/**
+ * Hash the edges of the graph, whatever order they were added in
+ * @return The sum of a mixed hash of every edge
+ */
+unsigned long long ALGraph::EdgeHash(void) const
+{
+  unsigned long long hash = Size();
+  for (unsigned node = 0; node < Size(); ++node)
+  {
+    ForEachEdge(node, [&](unsigned neighbour, unsigned weight)
+    {
+      unsigned long long key = (static_cast<unsigned long long>(node) << 32 | neighbour) ^
+                               (static_cast<unsigned long long>(weight) * 0x9E3779B97F4A7C15ull);
+      key ^= key >> 31;
+      key *= 0xBF58476D1CE4E5B9ull;
+      key ^= key >> 29;
+      hash += key;
+    });
+  }
+  return hash;
+}
+
+/**
+ * Find the number of edges from each node to the start with a breadth-first
+ * search
+ * Each level is found top-down, by following the edges out of the frontier,
+ * or, on a frozen graph, bottom-up: every node not reached yet looks through
+ * the edges into it for one from the frontier, which is kept as a bitmap.
+ * Bottom-up steps pay off once the frontier is large, since most unreached
+ * nodes then find a parent among their first few edges. The search switches
+ * when the frontier's edges outnumber a fraction of the unexplored ones and
+ * the frontier holds a fair share of the nodes, and back when it gets small
+ * again (Beamer, Asanovic and Patterson). Graphs whose frontier stays narrow,
+ * like road networks, are searched top-down throughout.
+ * @param start_node The 1-based starting node
+ * @param direction_optimizing Whether to use bottom-up steps on a frozen graph
+ * @return The number of edges on the shortest way to each node, INF for
+ *         unreachable nodes
+ * @throw std::out_of_range if the start is not in the graph
+ */
+std::vector<unsigned> ALGraph::BreadthFirst(unsigned start_node, bool direction_optimizing) const
+{
+  const unsigned size = Size();
+  if (start_node < 1 || start_node > size)
+    throw std::out_of_range("ALGraph::BreadthFirst: start out of range");
+
+  const unsigned ALPHA = 14; // Go bottom-up when the frontier has 1/ALPHA of the unexplored edges
+  const unsigned BETA = 24;  // Stay top-down while the frontier has fewer than 1/BETA of the nodes
+  const size_t words = (size + 63) / 64;
+
+  std::vector<unsigned> level(size, INF);
+  std::vector<unsigned> frontier(1, start_node - 1), next;
+  std::vector<unsigned long long> frontierBits, nextBits;
+  level[start_node - 1] = 0;
+
+  bool bottomUp = false;
+  unsigned long long unexplored = m_Edges.size(); // Edges not followed top-down yet
+  size_t count = 1;
+  for (unsigned depth = 1; count != 0; ++depth)
+  {
+    if (direction_optimizing && m_Frozen)
+    {
+      if (!bottomUp)
+      {
+        unsigned long long frontierEdges = 0;
+        for (unsigned node : frontier)
+          frontierEdges += OutDegree(node);
+        unexplored -= std::min(unexplored, frontierEdges);
+        if (frontierEdges > unexplored / ALPHA && count >= size / BETA)
+        {
+          bottomUp = true;
+          frontierBits.assign(words, 0);
+          for (unsigned node : frontier)
+            frontierBits[node / 64] |= 1ull << (node % 64);
+        }
+      }
+      else if (count < size / BETA)
+      {
+        bottomUp = false;
+        frontier.clear();
+        for (unsigned node = 0; node < size; ++node)
+        {
+          if (frontierBits[node / 64] >> (node % 64) & 1)
+            frontier.push_back(node);
+        }
+      }
+    }
+
+    count = 0;
+    if (bottomUp)
+    {
+      nextBits.assign(words, 0);
+      for (unsigned node = 0; node < size; ++node)
+      {
+        if (level[node] != INF)
+          continue;
+        const unsigned end = m_ReverseOffsets[node + 1];
+        for (unsigned edge = m_ReverseOffsets[node]; edge < end; ++edge)
+        {
+          unsigned parent = m_ReverseEdges[edge].to;
+          if (frontierBits[parent / 64] >> (parent % 64) & 1)
+          {
+            level[node] = depth;
+            nextBits[node / 64] |= 1ull << (node % 64);
+            ++count;
+            break;
+          }
+        }
+      }
+      frontierBits.swap(nextBits);
+    }
+    else
+    {
+      next.clear();
+      for (unsigned node : frontier)
+      {
+        ForEachEdge(node, [&](unsigned neighbour, unsigned)
+        {
+          if (level[neighbour] == INF)
+          {
+            level[neighbour] = depth;
+            next.push_back(neighbour);
+          }
+        });
+      }
+      frontier.swap(next);
+      count = frontier.size();
+    }
+  }
+
+  return level;
+}
+
+/**
+ * Find the nodes reachable from a node with a depth-first search
+ * The search keeps its own stack, so deep graphs cannot overflow the call
+ * stack, and takes the edges of each node in order, the same as a recursive
+ * search would.
+ * @param start_node The 1-based starting node
+ * @return The 1-based nodes in the order they are first reached
+ * @throw std::out_of_range if the start is not in the graph
+ */
+std::vector<unsigned> ALGraph::DepthFirst(unsigned start_node) const
+{
+  const unsigned size = Size();
+  if (start_node < 1 || start_node > size)
+    throw std::out_of_range("ALGraph::DepthFirst: start out of range");
+
+  std::vector<bool> seen(size, false);
+  std::vector<unsigned> order;
+  std::vector<std::pair<unsigned, unsigned>> stack; // each node and its next edge
+
+  seen[start_node - 1] = true;
+  order.push_back(start_node);
+  stack.push_back(std::make_pair(start_node - 1, 0u));
+  while (!stack.empty())
+  {
+    unsigned node = stack.back().first;
+    if (stack.back().second == OutDegree(node))
+    {
+      stack.pop_back(); // Done with this node
+      continue;
+    }
+
+    unsigned neighbour = Neighbour(node, stack.back().second++);
+    if (!seen[neighbour])
+    {
+      seen[neighbour] = true;
+      order.push_back(neighbour + 1);
+      stack.push_back(std::make_pair(neighbour, 0u));
+    }
+  }
+
+  return order;
+}
+
+/**
+ * Find the connected components, taking every edge in both directions
+ * The nodes are merged with a union-find over the edges, so the edges are
+ * read once, in order. Every set is rooted at its lowest node.
+ * @return The component of each node, numbered from 0 in order of their
+ *         lowest node
+ */
+std::vector<unsigned> ALGraph::ConnectedComponents(void) const
+{
+  const unsigned size = Size();
+  std::vector<unsigned> parent(size);
+  for (unsigned node = 0; node < size; ++node)
+    parent[node] = node;
+
+  // Find the root of a node, halving its path on the way
+  auto find = [&](unsigned node)
+  {
+    while (parent[node] != node)
+    {
+      parent[node] = parent[parent[node]];
+      node = parent[node];
+    }
+    return node;
+  };
+
+  for (unsigned node = 0; node < size; ++node)
+  {
+    ForEachEdge(node, [&](unsigned neighbour, unsigned)
+    {
+      unsigned a = find(node), b = find(neighbour);
+      if (a < b)
+        parent[b] = a;
+      else if (b < a)
+        parent[a] = b;
+    });
+  }
+
+  // A root comes before the other nodes of its set, so it is numbered first
+  std::vector<unsigned> component(size);
+  unsigned count = 0;
+  for (unsigned node = 0; node < size; ++node)
+  {
+    unsigned root = find(node);
+    component[node] = (root == node) ? count++ : component[root];
+  }
+  return component;
+}
+
+/**
+ * Find the strongly connected components with Tarjan's algorithm
+ * The depth-first search keeps its own stack. Tarjan's algorithm completes
+ * the components in reverse topological order; they are numbered the other
+ * way round, so that every edge between two components goes from a lower
+ * number to a higher one.
+ * @return The component of each node, numbered from 0 in topological order
+ */
+std::vector<unsigned> ALGraph::StrongComponents(void) const
+{
+  const unsigned size = Size();
+  std::vector<unsigned> index(size, INF);     // order in which the search reached each node
+  std::vector<unsigned> low(size);            // lowest index reachable through the search tree
+  std::vector<unsigned> component(size, INF); // INF while the node is unfinished
+  std::vector<unsigned> open;                 // nodes whose component is not complete
+  std::vector<std::pair<unsigned, unsigned>> stack; // each node and its next edge
+  unsigned reached = 0, count = 0;
+
+  for (unsigned root = 0; root < size; ++root)
+  {
+    if (index[root] != INF)
+      continue;
+
+    index[root] = low[root] = reached++;
+    open.push_back(root);
+    stack.push_back(std::make_pair(root, 0u));
+    while (!stack.empty())
+    {
+      unsigned node = stack.back().first;
+      if (stack.back().second < OutDegree(node))
+      {
+        unsigned neighbour = Neighbour(node, stack.back().second++);
+        if (index[neighbour] == INF)
+        {
+          index[neighbour] = low[neighbour] = reached++;
+          open.push_back(neighbour);
+          stack.push_back(std::make_pair(neighbour, 0u));
+        }
+        else if (component[neighbour] == INF) // Still open, so in this component or above
+          low[node] = std::min(low[node], index[neighbour]);
+        continue;
+      }
+
+      stack.pop_back();
+      if (!stack.empty())
+      {
+        unsigned parent = stack.back().first;
+        low[parent] = std::min(low[parent], low[node]);
+      }
+      if (low[node] == index[node]) // node is the first of its component
+      {
+        unsigned member;
+        do
+        {
+          member = open.back();
+          open.pop_back();
+          component[member] = count;
+        } while (member != node);
+        ++count;
+      }
+    }
+  }
+
+  for (unsigned node = 0; node < size; ++node)
+    component[node] = count - 1 - component[node];
+  return component;
+}
+
+/**
+ * Order the nodes so that every edge goes from an earlier node to a later one
+ * Kahn's algorithm: the nodes without incoming edges come first, in index
+ * order, and removing a node's edges frees the nodes that only it led to.
+ * @param order Set to the 1-based nodes in topological order; if the graph
+ *              has a cycle, only the nodes that come before every cycle
+ * @return False if the graph has a cycle
+ */
+bool ALGraph::TopologicalSort(std::vector<unsigned> &order) const
+{
+  const unsigned size = Size();
+  std::vector<unsigned> incoming(size, 0);
+  for (unsigned node = 0; node < size; ++node)
+  {
+    ForEachEdge(node, [&](unsigned neighbour, unsigned)
+    {
+      ++incoming[neighbour];
+    });
+  }
+
+  order.clear();
+  order.reserve(size);
+  for (unsigned node = 0; node < size; ++node)
+  {
+    if (incoming[node] == 0)
+      order.push_back(node);
+  }
+
+  // order doubles as the queue of nodes whose edges are still to be removed
+  for (size_t head = 0; head < order.size(); ++head)
+  {
+    ForEachEdge(order[head], [&](unsigned neighbour, unsigned)
+    {
+      if (--incoming[neighbour] == 0)
+        order.push_back(neighbour);
+    });
+  }
+
+  for (unsigned &node : order)
+    ++node; // Adjust for 1-based indexing
+  return order.size() == size;
+}
+
+/**
+ * Get the adjacency list representation of the graph
+ * A frozen graph builds it from the compressed rows.
+ * @return The adjacency list
+ */
+ALIST ALGraph::GetAList() const
+{
+  if (!m_Frozen)
+    return m_AdjacencyList;
+
+  ALIST alist(Size());
+  for (unsigned node = 0; node < alist.size(); ++node)
+  {
+    alist[node].reserve(m_Offsets[node + 1] - m_Offsets[node]);
+    ForEachEdge(node, [&](unsigned neighbour, unsigned weight)
+    {
+      alist[node].push_back(AdjacencyInfo{neighbour + 1, weight});
+    });
+  }
+  return alist;
+}
+
+/**
+ * Convert the graph to compressed sparse row form
+ * All edges are packed into one flat array, indexed by an array of offsets,
+ * and the per-node lists are released, so searches read the edges of a node
+ * from one contiguous run. The edges keep their order. The reversed edges are
+ * packed the same way for searches that run backwards from a target.
+ * Adding an edge later converts the graph back.
+ */
+void ALGraph::Freeze(void)
+{
+  if (m_Frozen)
+    return;
+
+  size_t edges = 0;
+  for (const auto &list : m_AdjacencyList)
+    edges += list.size();
+
+  m_Offsets.reserve(m_AdjacencyList.size() + 1);
+  m_Edges.reserve(edges);
+  m_Offsets.push_back(0);
+  for (const auto &list : m_AdjacencyList)
+  {
+    for (const AdjacencyInfo &info : list)
+      m_Edges.push_back(PackedEdge{info.id - 1, info.weight});
+    m_Offsets.push_back(static_cast<unsigned>(m_Edges.size()));
+  }
+
+  m_AdjacencyList.resize(0);
+  m_AdjacencyList.shrink_to_fit(); // Give back every per-node list
+  m_Frozen = true;
+  BuildReverse();
+}
+
+/**
+ * Build the reversed compressed rows from the forward ones
+ * The edges into each node are ordered by their source.
+ */
+void ALGraph::BuildReverse(void)
+{
+  const unsigned size = Size();
+  std::vector<unsigned> offsets(size + 1, 0);
+  for (const PackedEdge &edge : m_Edges)
+    ++offsets[edge.to + 1];
+  for (unsigned node = 0; node < size; ++node)
+    offsets[node + 1] += offsets[node];
+
+  std::vector<PackedEdge> reverse(m_Edges.size());
+  std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+  for (unsigned node = 0; node < size; ++node)
+  {
+    for (unsigned edge = m_Offsets[node]; edge < m_Offsets[node + 1]; ++edge)
+      reverse[next[m_Edges[edge].to]++] = PackedEdge{node, m_Edges[edge].weight};
+  }
+
+  m_ReverseOffsets.swap(offsets);
+  m_ReverseEdges.swap(reverse);
+}
+
+/**
+ * Check if the graph is in compressed sparse row form
+ * @return True after Freeze, until an edge is added
+ */
+bool ALGraph::IsFrozen(void) const
+{
+  return m_Frozen;
+}
+
+/**
+ * Get the number of nodes in the graph
+ * @return The number of nodes
+ */
+unsigned ALGraph::Size(void) const
+{
+  if (m_Frozen)
+    return static_cast<unsigned>(m_Offsets.size() - 1);
+  return static_cast<unsigned>(m_AdjacencyList.size());
+}
+
+/**
+ * Convert a frozen graph back to per-node lists
+ */
+void ALGraph::Thaw(void)
+{
+  ALIST alist = GetAList();
+  m_AdjacencyList.swap(alist);
+
+  std::vector<unsigned>().swap(m_Offsets);
+  std::vector<PackedEdge>().swap(m_Edges);
+  std::vector<unsigned>().swap(m_ReverseOffsets);
+  std::vector<PackedEdge>().swap(m_ReverseEdges);
+  m_Frozen = false;
+  DropHierarchy();
+}
+
+/**
+ * Constructor for the ShortestPathTree class
+ * The graph is frozen and the paths are found with a full search.
+ * @param graph The graph, changed only through the tree from now on
+ * @param source The 1-based starting node
+ * @throw std::out_of_range if the source is not in the graph
+ */
+ALGraph::ShortestPathTree::ShortestPathTree(ALGraph &graph, unsigned source)
+  : m_Graph(graph), m_Source(source - 1), m_Cost(graph.Size()), m_Previous(graph.Size()),
+    m_Heap(graph.Size()), m_Repaired(0)
+{
+  m_Graph.Freeze();
+  SearchQueues queues(m_Graph);
+  m_Graph.ShortestPaths(m_Source, m_Cost.data(), m_Previous.data(), queues);
+}
+
+/**
+ * Change the weight of an edge and repair the paths
+ * @param source The 1-based source node
+ * @param destination The 1-based destination node
+ * @param weight The new weight
+ * @return False if there is no such edge
+ * @throw std::out_of_range if a node is not in the graph
+ */
+bool ALGraph::ShortestPathTree::UpdateEdgeWeight(unsigned source, unsigned destination, unsigned weight)
+{
+  if (!m_Graph.UpdateEdgeWeight(source, destination, weight))
+    return false;
+  EdgeChanged(source - 1, destination - 1, weight);
+  return true;
+}
+
+/**
+ * Remove an edge and repair the paths
+ * @param source The 1-based source node
+ * @param destination The 1-based destination node
+ * @return False if there is no such edge
+ * @throw std::out_of_range if a node is not in the graph
+ */
+bool ALGraph::ShortestPathTree::RemoveEdge(unsigned source, unsigned destination)
+{
+  if (!m_Graph.RemoveEdge(source, destination))
+    return false;
+  EdgeChanged(source - 1, destination - 1, m_Graph.INF);
+  return true;
+}
+
+/**
+ * Get the cost of the path to a node
+ * @param node The 1-based node
+ * @return The cost, INF if the node is unreachable
+ */
+unsigned ALGraph::ShortestPathTree::Cost(unsigned node) const
+{
+  return m_Cost.at(node - 1);
+}
+
+/**
+ * Get the path to a node
+ * @param node The 1-based node
+ * @return The cost and the 1-based nodes of the path, no path if the node is
+ *         unreachable
+ */
+DijkstraInfo ALGraph::ShortestPathTree::Path(unsigned node) const
+{
+  DijkstraInfo info;
+  info.cost = m_Cost.at(node - 1);
+  if (info.cost == m_Graph.INF)
+    return info;
+
+  for (unsigned current = node - 1; current != m_Graph.INF; current = m_Previous[current])
+    info.path.push_back(current + 1);
+  std::reverse(info.path.begin(), info.path.end());
+  return info;
+}
+
+/**
+ * Get the cost of every node
+ * @return The costs, indexed by 0-based node, the same as DijkstraCosts
+ */
+const std::vector<unsigned> &ALGraph::ShortestPathTree::Costs(void) const
+{
+  return m_Cost;
+}
+
+/**
+ * Get the amount of work the last change took
+ * @return The number of nodes whose cost was looked at again
+ */
+unsigned ALGraph::ShortestPathTree::Repaired(void) const
+{
+  return m_Repaired;
+}
+
+/**
+ * Repair the paths after the weight of an edge changed
+ * A cheaper edge can only make its destination and the nodes after it
+ * cheaper, so the search simply goes on from there. A dearer (or removed)
+ * edge only matters if the path to its destination used it; then that node
+ * and every node whose path went through it are found again.
+ * @param source The 0-based source of the edge
+ * @param destination The 0-based destination of the edge
+ * @param weight The new weight, INF for a removed edge
+ */
+void ALGraph::ShortestPathTree::EdgeChanged(unsigned source, unsigned destination, unsigned weight)
+{
+  const unsigned INF = m_Graph.INF;
+  m_Repaired = 0;
+
+  unsigned through = (m_Cost[source] == INF || weight == INF) ? INF : m_Cost[source] + weight;
+  if (through < m_Cost[destination])
+  {
+    m_Cost[destination] = through;
+    m_Previous[destination] = source;
+    m_Heap.Push(destination, through);
+    Propagate();
+  }
+  else if (m_Previous[destination] == source && through != m_Cost[destination])
+    Raised(destination);
+}
+
+/**
+ * Run Dijkstra's algorithm on from the nodes in the heap
+ * Only nodes that get cheaper are pushed, so the search stays within the
+ * part of the graph whose costs change.
+ */
+void ALGraph::ShortestPathTree::Propagate(void)
+{
+  while (!m_Heap.Empty())
+  {
+    unsigned current = m_Heap.Pop();
+    ++m_Repaired;
+    m_Graph.ForEachEdge(current, [&](unsigned neighbour, unsigned weight)
+    {
+      unsigned newCost = m_Cost[current] + weight;
+      if (newCost < m_Cost[neighbour])
+      {
+        m_Cost[neighbour] = newCost;
+        m_Previous[neighbour] = current;
+        m_Heap.Push(neighbour, newCost);
+      }
+    });
+  }
+}
+
+/**
+ * Find the paths again for a node whose path got dearer and every node
+ * whose path went through it
+ * Those nodes are collected from the tree and marked unreachable. Each then
+ * gets the best offer from the nodes outside, over the edges into it, and
+ * Dijkstra's algorithm settles them from there.
+ * @param node The 0-based node whose path got dearer
+ */
+void ALGraph::ShortestPathTree::Raised(unsigned node)
+{
+  const unsigned INF = m_Graph.INF;
+
+  // The subtree: the tree edges of a node are the edges to the nodes that
+  // have it as their previous node
+  m_Subtree.assign(1, node);
+  for (size_t next = 0; next < m_Subtree.size(); ++next)
+  {
+    unsigned parent = m_Subtree[next];
+    m_Graph.ForEachEdge(parent, [&](unsigned child, unsigned)
+    {
+      if (m_Previous[child] == parent && m_Cost[child] != INF)
+      {
+        m_Cost[child] = INF; // Also keeps it from being taken twice
+        m_Subtree.push_back(child);
+      }
+    });
+  }
+  for (unsigned member : m_Subtree)
+    m_Cost[member] = INF;
+
+  // The best way into each of them from a node whose cost still holds
+  m_Offer.assign(m_Subtree.size(), INF);
+  for (size_t i = 0; i < m_Subtree.size(); ++i)
+  {
+    unsigned member = m_Subtree[i];
+    m_Previous[member] = INF;
+    m_Graph.ForEachInEdge(member, [&](unsigned from, unsigned weight)
+    {
+      if (m_Cost[from] != INF && m_Cost[from] + weight < m_Offer[i])
+      {
+        m_Offer[i] = m_Cost[from] + weight;
+        m_Previous[member] = from;
+      }
+    });
+  }
+  for (size_t i = 0; i < m_Subtree.size(); ++i)
+  {
+    if (m_Offer[i] != INF)
+    {
+      m_Cost[m_Subtree[i]] = m_Offer[i];
+      m_Heap.Push(m_Subtree[i], m_Offer[i]);
+    }
+  }
+
+  Propagate();
+  m_Repaired = std::max(m_Repaired, static_cast<unsigned>(m_Subtree.size()));
+}
@@ -14,6 +14,9 @@ This file contains the declaration for the ALGraph
 //---------------------------------------------------------------------------
 #include <vector>
 #include <limits>
+#include <istream>
+#include <ostream>
+#include <functional>
 
 struct DijkstraInfo
 {
@@ -29,28 +32,147 @@ struct AdjacencyInfo
 
 typedef std::vector<std::vector<AdjacencyInfo>> ALIST;
 
+// Shortest path costs from several sources: the entries for the source at
+// index s are cost/previous[s * nodes .. (s + 1) * nodes). previous holds the
+// 1-based node before each node on its path (0 for none) and is only filled
+// on request.
+struct DistanceMatrix
+{
+  unsigned sources;
+  unsigned nodes;
+  std::vector<unsigned> cost;
+  std::vector<unsigned> previous;
+};
+
+struct EdgeInfo
+{
+  unsigned source;
+  unsigned destination;
+  unsigned weight;
+};
+
 class ALGraph
 {
 public:
+  // Lower bound on the cost from a 1-based node to the target of a query
+  typedef std::function<unsigned(unsigned)> Heuristic;
+
+  class ShortestPathTree;
+
   ALGraph(unsigned size);
   ~ALGraph(void);
   void AddDEdge(unsigned source, unsigned destination, unsigned weight);
   void AddUEdge(unsigned node1, unsigned node2, unsigned weight);
+  void AddEdges(const std::vector<EdgeInfo> &edges, bool undirected = false);
+  bool LoadEdges(const char *filename, bool undirected = false);
+  bool LoadEdges(std::istream &stream, bool undirected = false);
+  bool UpdateEdgeWeight(unsigned source, unsigned destination, unsigned weight);
+  bool RemoveEdge(unsigned source, unsigned destination);
 
   std::vector<DijkstraInfo> Dijkstra(unsigned start_node) const;
+  std::vector<unsigned> DijkstraCosts(unsigned start_node) const;
+  std::vector<unsigned> DeltaStepping(unsigned start_node, unsigned delta = 0, unsigned threads = 0) const;
+  DistanceMatrix DijkstraMany(const std::vector<unsigned> &sources, bool predecessors = false,
+                              unsigned threads = 0) const;
+  DijkstraInfo ShortestPath(unsigned source, unsigned target, unsigned *settled = nullptr) const;
+  DijkstraInfo ShortestPath(unsigned source, unsigned target, const Heuristic &heuristic,
+                            unsigned *settled = nullptr) const;
   ALIST GetAList(void) const;
 
+  std::vector<unsigned> BreadthFirst(unsigned start_node, bool direction_optimizing = true) const;
+  std::vector<unsigned> DepthFirst(unsigned start_node) const;
+  std::vector<unsigned> ConnectedComponents(void) const;
+  std::vector<unsigned> StrongComponents(void) const;
+  bool TopologicalSort(std::vector<unsigned> &order) const;
+
+  void Freeze(void);
+  bool IsFrozen(void) const;
+  unsigned Size(void) const;
+
+  void Contract(void);
+  bool IsContracted(void) const;
+  bool SaveHierarchy(const char *filename) const;
+  bool SaveHierarchy(std::ostream &stream) const;
+  bool LoadHierarchy(const char *filename);
+  bool LoadHierarchy(std::istream &stream);
+
 private:
   // An EXAMPLE of some other classes you may want to create and
   // implement in ALGraph.cpp
-  struct GNode
+  // Binary min-heap of node indices that supports decrease-key
+  class NodeHeap
+  {
+  public:
+    NodeHeap(unsigned size);
+    bool Empty(void) const;
+    unsigned TopCost(void) const;
+    void Push(unsigned node, unsigned cost);
+    unsigned Pop(void);
+    void Clear(void);
+
+  private:
+    bool Less(unsigned a, unsigned b) const;
+    void SiftUp(unsigned slot);
+    void SiftDown(unsigned slot);
+    void Place(unsigned slot, unsigned node);
+
+    std::vector<unsigned> m_Heap;     // node indices, cheapest first
+    std::vector<unsigned> m_Slot;     // position of each node in m_Heap
+    std::vector<unsigned> m_Cost;     // key of each node
+  };
+
+  // Dial's bucket queue for integer costs: a ring of maxWeight + 1 buckets,
+  // one per pending cost, since a search never has costs further apart.
+  // A node is pushed again instead of moved, so it may come out more than
+  // once; the extra entries have a cost above the node's final one.
+  class BucketQueue
+  {
+  public:
+    BucketQueue(unsigned maxWeight);
+    bool Empty(void) const;
+    unsigned TopCost(void) const;
+    void Push(unsigned node, unsigned cost);
+    unsigned Pop(void);
+
+  private:
+    void Advance(void);
+
+    std::vector<std::vector<unsigned>> m_Buckets; // nodes by cost modulo the ring size
+    unsigned m_Current;                           // cost of the current bucket
+    size_t m_Count;                               // entries in all buckets
+    bool m_Sorted;                                // whether the current bucket is in index order
+  };
+
+  // The queue Dijkstra uses, picked from the edge weights of the graph
+  enum QueueKind { BINARY_HEAP, BUCKET_QUEUE };
+
+  // Queues for one search at a time, kept so that later searches reuse their
+  // memory; only the one PickQueue chose is given room
+  struct SearchQueues
+  {
+    SearchQueues(const ALGraph &graph);
+
+    QueueKind kind;
+    NodeHeap heap;
+    BucketQueue buckets;
+  };
+
+  // Scratch state of one point-to-point search, reused between queries so
+  // that a query only pays for the nodes it reaches
+  struct SearchSpace
   {
-    unsigned m_id;
-    bool m_Evaluated;
-    DijkstraInfo info;
-    bool operator<(const GNode &rhs) const;
+    SearchSpace(void);
+    void Prepare(unsigned size);
+    void Label(unsigned node, unsigned cost, unsigned previous);
+    void Reset(void);
+
+    std::vector<unsigned> cost;     // best known cost, INF if not reached
+    std::vector<unsigned> previous; // the node before (or after) on the path
+    std::vector<unsigned> touched;  // nodes to reset after the query
+    NodeHeap heap;
   };
   class GEdge;
+  class Contraction;
   struct AdjInfo
   {
     //unsigned node;
@@ -62,8 +184,97 @@ private:
   };
 
   // Other private fields and methods
-  ALIST m_AdjacencyList;
+  void Thaw(void);
+  QueueKind PickQueue(void) const;
+  void ShortestPaths(unsigned start, unsigned *cost, unsigned *previous,
+                     SearchQueues &queues) const;
+  template <typename Queue>
+  void Settle(unsigned start, unsigned *cost, unsigned *previous, Queue &queue) const;
+  void BuildReverse(void);
+  void DropHierarchy(void);
+  unsigned long long EdgeHash(void) const;
+  DijkstraInfo SearchTo(unsigned source, unsigned target, const Heuristic *heuristic,
+                        unsigned *settled) const;
+  DijkstraInfo MakePath(const SearchSpace &forward, const SearchSpace *backward,
+                        unsigned from, unsigned to, unsigned cost) const;
+  DijkstraInfo HierarchyPath(unsigned source, unsigned target, SearchSpace &forward,
+                             SearchSpace &backward, unsigned *settled) const;
+  void UnpackEdge(unsigned from, unsigned to, std::vector<unsigned> &path) const;
+  unsigned OutDegree(unsigned node) const;
+  unsigned Neighbour(unsigned node, unsigned index) const;
+  template <typename Visit>
+  void ForEachEdge(unsigned node, Visit visit) const;
+  template <typename Visit>
+  void ForEachInEdge(unsigned node, Visit visit) const;
+
+  ALIST m_AdjacencyList;             // per-node edge lists, empty while frozen
+
+  // An edge in compressed sparse row form
+  struct PackedEdge
+  {
+    unsigned to;     // 0-based destination
+    unsigned weight;
+  };
+
+  // Compressed sparse row form, filled by Freeze: the edges of node i are
+  // m_Edges[m_Offsets[i] .. m_Offsets[i + 1])
+  std::vector<unsigned> m_Offsets;
+  std::vector<PackedEdge> m_Edges;
+
+  // The same for the reversed edges: to is the 0-based source of the edge
+  std::vector<unsigned> m_ReverseOffsets;
+  std::vector<PackedEdge> m_ReverseEdges;
+  bool m_Frozen;
+  unsigned m_MinWeight;              // lightest edge, INF without edges; a lower bound once edges change
+  unsigned m_MaxWeight;              // heaviest edge, 0 without edges; an upper bound once edges change
+
+  // An edge of the contraction hierarchy, stored with the lower ranked node
+  struct HierarchyEdge
+  {
+    unsigned to;     // 0-based node of higher rank
+    unsigned weight;
+    unsigned middle; // 0-based node the shortcut passes, INF for an edge of the graph
+  };
+
+  // Contraction hierarchy, filled by Contract or LoadHierarchy: the position
+  // of each node in the contraction order, the edges leaving each node
+  // upwards, and the edges entering each node from above (to is their source)
+  std::vector<unsigned> m_Rank;
+  std::vector<unsigned> m_UpOffsets;
+  std::vector<HierarchyEdge> m_UpEdges;
+  std::vector<unsigned> m_DownOffsets;
+  std::vector<HierarchyEdge> m_DownEdges;
   const unsigned INF = static_cast<unsigned>(-1);
 };
 
+// Shortest paths from one source, repaired instead of recomputed when an
+// edge changes. The tree works on the frozen graph and has to make every
+// change to it while it is in use, since it cannot see the others.
+class ALGraph::ShortestPathTree
+{
+public:
+  ShortestPathTree(ALGraph &graph, unsigned source);
+  bool UpdateEdgeWeight(unsigned source, unsigned destination, unsigned weight);
+  bool RemoveEdge(unsigned source, unsigned destination);
+
+  unsigned Cost(unsigned node) const;
+  DijkstraInfo Path(unsigned node) const;
+  const std::vector<unsigned> &Costs(void) const;
+  unsigned Repaired(void) const;
+
+private:
+  void EdgeChanged(unsigned source, unsigned destination, unsigned weight);
+  void Propagate(void);
+  void Raised(unsigned node);
+
+  ALGraph &m_Graph;
+  unsigned m_Source;               // 0-based
+  std::vector<unsigned> m_Cost;    // cost of each node, INF if unreachable
+  std::vector<unsigned> m_Previous; // the node before each node on its path, INF for none
+  NodeHeap m_Heap;
+  std::vector<unsigned> m_Subtree; // nodes whose path went through a dearer edge
+  std::vector<unsigned> m_Offer;   // best cost for each of them from outside
+  unsigned m_Repaired;             // nodes whose cost the last change touched
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,590 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <fstream>
+#include <cstdio>
+#include <thread>
+
+#include "ALGraph.h"
+
+unsigned gSide = 1000; // Road graphs are gSide x gSide grids
+int gRounds = 3;       // Searches per measurement
+
+using std::cout;
+using std::endl;
+
+//*********************************************************************
+// Helpers
+//*********************************************************************
+
+  // A grid with random weights, like a road network: few edges per node and
+  // nearby nodes have nearby ids. The edges are added in random order, the way
+  // they come from a file, so the per-node lists end up scattered in memory.
+void MakeRoadGraph(ALGraph &graph, unsigned side, unsigned seed, unsigned minWeight = 1)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned> weight(minWeight, 100);
+
+  std::vector<std::pair<unsigned, unsigned> > edges;
+  for (unsigned row = 0; row < side; row++)
+  {
+    for (unsigned col = 0; col < side; col++)
+    {
+      unsigned node = row * side + col + 1;
+      if (col + 1 < side)
+        edges.push_back(std::make_pair(node, node + 1));
+      if (row + 1 < side)
+        edges.push_back(std::make_pair(node, node + side));
+    }
+  }
+  std::shuffle(edges.begin(), edges.end(), rng);
+
+  for (size_t i = 0; i < edges.size(); i++)
+    graph.AddUEdge(edges[i].first, edges[i].second, weight(rng));
+}
+
+  // Runs DijkstraCosts from gRounds start nodes, returns the elapsed milliseconds
+double TimeDijkstra(const ALGraph &graph, unsigned long long &checksum)
+{
+  checksum = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int r = 0; r < gRounds; r++)
+  {
+    unsigned source = 1 + static_cast<unsigned>(r) * (graph.Size() / gRounds);
+    std::vector<unsigned> cost = graph.DijkstraCosts(source);
+    for (size_t i = 0; i < cost.size(); i++)
+      checksum += cost[i];
+  }
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+  // Milliseconds since a starting point
+double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void PrintResult(const char *name, double ms, unsigned long long checksum)
+{
+  cout << std::left << std::setw(18) << name << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ms / gRounds << " ms/search";
+  cout << "  checksum: " << checksum << endl;
+}
+
+//*********************************************************************
+// Benchmarks
+//*********************************************************************
+
+  // Dijkstra on per-node edge lists against the compressed sparse row form
+void BenchFreeze(void)
+{
+  const char *test = "BenchFreeze";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  ALGraph graph(gSide * gSide);
+  MakeRoadGraph(graph, gSide, 1);
+  cout << "nodes: " << graph.Size() << ", searches: " << gRounds << endl;
+
+  unsigned long long checksum;
+  double ms = TimeDijkstra(graph, checksum);
+  PrintResult("adjacency lists", ms, checksum);
+
+  graph.Freeze();
+  ms = TimeDijkstra(graph, checksum);
+  PrintResult("frozen (CSR)", ms, checksum);
+}
+
+  // One edge at a time into sorted lists against one batch, and loading from a file
+void BenchLoad(void)
+{
+  const char *test = "BenchLoad";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  unsigned nodes = gSide * gSide / 10;
+  std::mt19937 rng(2);
+  std::uniform_int_distribution<unsigned> node(1, nodes);
+  std::uniform_int_distribution<unsigned> weight(1, 100);
+  std::vector<EdgeInfo> edges(nodes * 50);
+  for (size_t i = 0; i < edges.size(); i++)
+    edges[i] = EdgeInfo{node(rng), node(rng), weight(rng)};
+  cout << "nodes: " << nodes << ", edges: " << edges.size() << endl;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  ALGraph single(nodes);
+  for (size_t i = 0; i < edges.size(); i++)
+    single.AddDEdge(edges[i].source, edges[i].destination, edges[i].weight);
+  cout << std::left << std::setw(18) << "AddDEdge" << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ElapsedMs(start) << " ms" << endl;
+
+  start = std::chrono::steady_clock::now();
+  ALGraph batch(nodes);
+  batch.AddEdges(edges);
+  cout << std::left << std::setw(18) << "AddEdges" << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ElapsedMs(start) << " ms" << endl;
+
+  const char *filename = "bench-edges.txt";
+  {
+    std::ofstream file(filename);
+    for (size_t i = 0; i < edges.size(); i++)
+      file << edges[i].source << ' ' << edges[i].destination << ' ' << edges[i].weight << '\n';
+  }
+  start = std::chrono::steady_clock::now();
+  ALGraph loaded(nodes);
+  bool ok = loaded.LoadEdges(filename);
+  cout << std::left << std::setw(18) << "LoadEdges" << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ElapsedMs(start) << " ms";
+  cout << (ok ? "" : "  (failed)") << endl;
+  std::remove(filename);
+
+  unsigned long long checksum[3];
+  TimeDijkstra(single, checksum[0]);
+  TimeDijkstra(batch, checksum[1]);
+  TimeDijkstra(loaded, checksum[2]);
+  cout << "same costs: " << (checksum[0] == checksum[1] && checksum[1] == checksum[2] ? "yes" : "no") << endl;
+}
+
+  // Distance matrix for many sources on 1-32 threads
+void BenchMany(void)
+{
+  const char *test = "BenchMany";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  unsigned side = gSide / 4;
+  ALGraph graph(side * side);
+  MakeRoadGraph(graph, side, 3);
+  graph.Freeze();
+
+  std::vector<unsigned> sources(128);
+  for (unsigned i = 0; i < sources.size(); i++)
+    sources[i] = 1 + i * (graph.Size() / static_cast<unsigned>(sources.size()));
+  cout << "nodes: " << graph.Size() << ", sources: " << sources.size();
+  cout << ", hardware threads: " << std::thread::hardware_concurrency() << endl;
+
+  double single = 0;
+  unsigned long long first = 0;
+  for (unsigned threads = 1; threads <= 32; threads *= 2)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    DistanceMatrix matrix = graph.DijkstraMany(sources, false, threads);
+    double ms = ElapsedMs(start);
+
+    unsigned long long checksum = 0;
+    for (size_t i = 0; i < matrix.cost.size(); i++)
+      checksum += matrix.cost[i];
+    if (threads == 1)
+    {
+      single = ms;
+      first = checksum;
+    }
+
+    cout << "threads: " << std::setw(2) << threads;
+    cout << "  time: " << std::setw(9) << std::fixed << std::setprecision(2) << ms << " ms";
+    cout << "  speedup: " << std::setw(5) << std::setprecision(2) << single / ms;
+    cout << (checksum == first ? "" : "  (different costs)") << endl;
+  }
+}
+
+  // Point-to-point queries: full Dijkstra against bidirectional search and A*
+void BenchPoint(void)
+{
+  const char *test = "BenchPoint";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  const unsigned minWeight = 50;
+  ALGraph graph(gSide * gSide);
+  MakeRoadGraph(graph, gSide, 4, minWeight);
+  graph.Freeze();
+
+  std::mt19937 rng(5);
+  std::uniform_int_distribution<unsigned> node(1, graph.Size());
+  std::vector<std::pair<unsigned, unsigned> > queries(gRounds * 10);
+  for (size_t i = 0; i < queries.size(); i++)
+    queries[i] = std::make_pair(node(rng), node(rng));
+  cout << "nodes: " << graph.Size() << ", queries: " << queries.size() << endl;
+
+    // Every edge costs at least minWeight per grid step
+  unsigned target = 0;
+  ALGraph::Heuristic manhattan = [&](unsigned id)
+  {
+    unsigned row = (id - 1) / gSide, col = (id - 1) % gSide;
+    unsigned targetRow = (target - 1) / gSide, targetCol = (target - 1) % gSide;
+    unsigned rows = row > targetRow ? row - targetRow : targetRow - row;
+    unsigned cols = col > targetCol ? col - targetCol : targetCol - col;
+    return (rows + cols) * minWeight;
+  };
+
+  const char *names[] = {"full Dijkstra", "bidirectional", "A*"};
+  std::vector<unsigned> reference;
+  for (int mode = 0; mode < 3; mode++)
+  {
+    size_t count = mode == 0 ? static_cast<size_t>(gRounds) : queries.size();
+    unsigned long long settled = 0;
+    std::vector<unsigned> costs;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+    {
+      unsigned visited = graph.Size();
+      target = queries[i].second;
+      if (mode == 0)
+        costs.push_back(graph.DijkstraCosts(queries[i].first)[target - 1]);
+      else if (mode == 1)
+        costs.push_back(graph.ShortestPath(queries[i].first, target, &visited).cost);
+      else
+        costs.push_back(graph.ShortestPath(queries[i].first, target, manhattan, &visited).cost);
+      settled += visited;
+    }
+    double ms = ElapsedMs(start);
+
+    if (mode == 0)
+      reference = costs; // The first queries, answered by every mode
+    bool same = std::equal(reference.begin(), reference.end(), costs.begin());
+
+    cout << std::left << std::setw(18) << names[mode] << std::right;
+    cout << " time: " << std::setw(9) << std::fixed << std::setprecision(3) << ms / static_cast<double>(count) << " ms/query";
+    cout << "  settled: " << std::setw(5) << std::setprecision(1) << 100.0 * static_cast<double>(settled) / static_cast<double>(count) / graph.Size() << "%";
+    cout << (same ? "" : "  (different costs)") << endl;
+  }
+}
+
+  // Serial Dijkstra against delta-stepping for a few deltas and thread counts
+void BenchDelta(void)
+{
+  const char *test = "BenchDelta";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  ALGraph graph(gSide * gSide);
+  MakeRoadGraph(graph, gSide, 6);
+  graph.Freeze();
+  cout << "nodes: " << graph.Size() << ", searches: " << gRounds;
+  cout << ", hardware threads: " << std::thread::hardware_concurrency() << endl;
+
+  unsigned long long reference;
+  double ms = TimeDijkstra(graph, reference);
+  PrintResult("Dijkstra", ms, reference);
+
+  const unsigned deltas[] = {0, 10, 50, 200};
+  for (size_t d = 0; d < sizeof(deltas) / sizeof(*deltas); d++)
+  {
+    for (unsigned threads = 1; threads <= 4; threads *= 2)
+    {
+      unsigned long long checksum = 0;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      for (int r = 0; r < gRounds; r++)
+      {
+        unsigned source = 1 + static_cast<unsigned>(r) * (graph.Size() / gRounds);
+        std::vector<unsigned> cost = graph.DeltaStepping(source, deltas[d], threads);
+        for (size_t i = 0; i < cost.size(); i++)
+          checksum += cost[i];
+      }
+      ms = ElapsedMs(start);
+
+      char name[32];
+      if (deltas[d])
+        std::snprintf(name, sizeof(name), "delta %u, %u thr", deltas[d], threads);
+      else
+        std::snprintf(name, sizeof(name), "delta auto, %u thr", threads);
+      PrintResult(name, ms, checksum);
+      if (checksum != reference)
+        cout << "  (different costs)" << endl;
+    }
+  }
+}
+
+  // Times point-to-point queries, keeps their costs
+void TimeQueries(const ALGraph &graph, const char *name,
+                 const std::vector<std::pair<unsigned, unsigned> > &queries, std::vector<unsigned> &costs)
+{
+  unsigned long long settled = 0;
+  costs.clear();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < queries.size(); i++)
+  {
+    unsigned visited = 0;
+    costs.push_back(graph.ShortestPath(queries[i].first, queries[i].second, &visited).cost);
+    settled += visited;
+  }
+  double ms = ElapsedMs(start);
+
+  cout << std::left << std::setw(18) << name << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << 1000 * ms / static_cast<double>(queries.size()) << " us/query";
+  cout << "  settled: " << settled / queries.size() << endl;
+}
+
+  // Bidirectional search against queries on a contraction hierarchy
+void BenchHierarchy(void)
+{
+  const char *test = "BenchHierarchy";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  unsigned side = gSide / 4;
+  ALGraph graph(side * side);
+  MakeRoadGraph(graph, side, 7);
+  graph.Freeze();
+
+  std::mt19937 rng(8);
+  std::uniform_int_distribution<unsigned> node(1, graph.Size());
+  std::vector<std::pair<unsigned, unsigned> > queries(gRounds * 100);
+  for (size_t i = 0; i < queries.size(); i++)
+    queries[i] = std::make_pair(node(rng), node(rng));
+  cout << "nodes: " << graph.Size() << ", queries: " << queries.size() << endl;
+
+  std::vector<unsigned> reference, costs;
+  TimeQueries(graph, "bidirectional", queries, reference);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  graph.Contract();
+  cout << std::left << std::setw(18) << "Contract" << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ElapsedMs(start) << " ms" << endl;
+  TimeQueries(graph, "hierarchy", queries, costs);
+  cout << "same costs: " << (costs == reference ? "yes" : "no") << endl;
+
+  const char *filename = "bench-hierarchy.bin";
+  graph.SaveHierarchy(filename);
+  ALGraph loaded(side * side);
+  MakeRoadGraph(loaded, side, 7);
+  start = std::chrono::steady_clock::now();
+  bool ok = loaded.LoadHierarchy(filename);
+  cout << std::left << std::setw(18) << "LoadHierarchy" << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ElapsedMs(start) << " ms";
+  cout << (ok ? "" : "  (failed)") << endl;
+  std::remove(filename);
+  TimeQueries(loaded, "loaded hierarchy", queries, costs);
+  cout << "same costs: " << (costs == reference ? "yes" : "no") << endl;
+}
+
+  // Dijkstra with the queue picked from the weights against the binary heap
+void BenchQueues(void)
+{
+  const char *test = "BenchQueues";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  const unsigned maxWeights[] = {10, 100, 4096, 1000000};
+  for (size_t w = 0; w < sizeof(maxWeights) / sizeof(*maxWeights); w++)
+  {
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<unsigned> weight(1, maxWeights[w]);
+    std::vector<EdgeInfo> edges;
+    for (unsigned row = 0; row < gSide; row++)
+    {
+      for (unsigned col = 0; col < gSide; col++)
+      {
+        unsigned node = row * gSide + col + 1;
+        if (col + 1 < gSide)
+          edges.push_back(EdgeInfo{node, node + 1, weight(rng)});
+        if (row + 1 < gSide)
+          edges.push_back(EdgeInfo{node, node + gSide, weight(rng)});
+      }
+    }
+    ALGraph graph(gSide * gSide);
+    graph.AddEdges(edges, true);
+    cout << "weights 1-" << maxWeights[w] << endl;
+
+    unsigned long long checksum[2];
+    double ms = TimeDijkstra(graph, checksum[0]);
+    PrintResult(maxWeights[w] <= 4096 ? "  bucket queue" : "  picked (heap)", ms, checksum[0]);
+
+      // A loop of weight 0 changes no cost, but only the binary heap takes it
+    graph.AddDEdge(1, 1, 0);
+    graph.Freeze();
+    ms = TimeDijkstra(graph, checksum[1]);
+    PrintResult("  binary heap", ms, checksum[1]);
+    if (checksum[0] != checksum[1])
+      cout << "  (different costs)" << endl;
+  }
+}
+
+  // Prints the time of one step
+void PrintStep(const char *name, double ms, unsigned long long checksum)
+{
+  cout << std::left << std::setw(18) << name << std::right;
+  cout << " time: " << std::setw(9) << std::fixed << std::setprecision(2) << ms << " ms";
+  cout << "  checksum: " << checksum << endl;
+}
+
+  // Runs every traversal on one graph
+void TimeTraversals(const ALGraph &graph)
+{
+  unsigned long long checksum = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::vector<unsigned> costs = graph.DijkstraCosts(1);
+  for (size_t i = 0; i < costs.size(); i++)
+    checksum += costs[i];
+  PrintStep("Dijkstra", ElapsedMs(start), checksum);
+
+  for (int optimizing = 0; optimizing < 2; optimizing++)
+  {
+    checksum = 0;
+    start = std::chrono::steady_clock::now();
+    std::vector<unsigned> levels = graph.BreadthFirst(1, optimizing != 0);
+    for (size_t i = 0; i < levels.size(); i++)
+      checksum += levels[i];
+    PrintStep(optimizing ? "BFS (optimizing)" : "BFS (top-down)", ElapsedMs(start), checksum);
+  }
+
+  start = std::chrono::steady_clock::now();
+  std::vector<unsigned> order = graph.DepthFirst(1);
+  PrintStep("DFS", ElapsedMs(start), order.size());
+
+  start = std::chrono::steady_clock::now();
+  std::vector<unsigned> components = graph.ConnectedComponents();
+  PrintStep("components", ElapsedMs(start), *std::max_element(components.begin(), components.end()) + 1);
+
+  start = std::chrono::steady_clock::now();
+  components = graph.StrongComponents();
+  PrintStep("strong components", ElapsedMs(start), *std::max_element(components.begin(), components.end()) + 1);
+
+  start = std::chrono::steady_clock::now();
+  bool acyclic = graph.TopologicalSort(order);
+  PrintStep(acyclic ? "topological sort" : "topological (cyc)", ElapsedMs(start), order.size());
+}
+
+  // Traversals on a road grid, a random graph and a random DAG
+void BenchTraversal(void)
+{
+  const char *test = "BenchTraversal";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  ALGraph road(gSide * gSide);
+  MakeRoadGraph(road, gSide, 10);
+  road.Freeze();
+  cout << "road grid, nodes: " << road.Size() << endl;
+  TimeTraversals(road);
+
+  const unsigned nodes = gSide * gSide;
+  std::mt19937 rng(11);
+  std::uniform_int_distribution<unsigned> node(1, nodes);
+  std::vector<EdgeInfo> edges(static_cast<size_t>(nodes) * 8);
+  for (size_t i = 0; i < edges.size(); i++)
+    edges[i] = EdgeInfo{node(rng), node(rng), 1};
+  {
+    ALGraph random(nodes);
+    random.AddEdges(edges, true);
+    cout << "random graph, nodes: " << nodes << ", edges: " << 2 * edges.size() << endl;
+    TimeTraversals(random);
+  }
+
+  for (size_t i = 0; i < edges.size(); i++) // Every edge to a higher node
+  {
+    if (edges[i].source == edges[i].destination)
+      edges[i].destination = edges[i].source == nodes ? 1 : edges[i].source + 1;
+    if (edges[i].source > edges[i].destination)
+      std::swap(edges[i].source, edges[i].destination);
+  }
+  ALGraph dag(nodes);
+  dag.AddEdges(edges);
+  cout << "random DAG, nodes: " << nodes << ", edges: " << edges.size() << endl;
+  TimeTraversals(dag);
+}
+
+  // Repairs a cached shortest path tree after single edge changes
+void BenchDynamic(void)
+{
+  const char *test = "BenchDynamic";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  ALGraph graph(gSide * gSide);
+  MakeRoadGraph(graph, gSide, 12);
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  ALGraph::ShortestPathTree tree(graph, 1);
+  cout << "nodes: " << graph.Size() << ", first search: " << std::fixed << std::setprecision(2);
+  cout << ElapsedMs(start) << " ms" << endl;
+
+  const int changes = 1000;
+  std::mt19937 rng(13);
+  std::uniform_int_distribution<unsigned> node(0, gSide * gSide - 1), weight(1, 100);
+  unsigned long long repaired = 0;
+  double ms = 0;
+  for (int c = 0; c < changes; c++)
+  {
+    // A road segment that is not on the edge of the grid, in one direction
+    unsigned from = node(rng), row = from / gSide, col = from % gSide;
+    if (row + 1 == gSide || col + 1 == gSide)
+      continue;
+    unsigned to = (rng() % 2) ? from + 1 : from + gSide;
+    if (rng() % 2)
+      std::swap(from, to);
+
+    start = std::chrono::steady_clock::now();
+    if (c % 10 == 9)
+      tree.RemoveEdge(from + 1, to + 1);
+    else
+      tree.UpdateEdgeWeight(from + 1, to + 1, weight(rng));
+    ms += ElapsedMs(start);
+    repaired += tree.Repaired();
+  }
+
+  unsigned long long checksum = 0;
+  for (size_t i = 0; i < tree.Costs().size(); i++)
+    checksum += tree.Costs()[i];
+  cout << std::left << std::setw(18) << "repair" << std::right;
+  cout << " time: " << std::setw(9) << ms / changes << " ms/change";
+  cout << "  nodes: " << repaired / changes << "  checksum: " << checksum << endl;
+
+  unsigned long long reference = 0;
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < gRounds; r++)
+  {
+    std::vector<unsigned> cost = graph.DijkstraCosts(1);
+    reference = 0;
+    for (size_t i = 0; i < cost.size(); i++)
+      reference += cost[i];
+  }
+  cout << std::left << std::setw(18) << "full search" << std::right;
+  cout << " time: " << std::setw(9) << ElapsedMs(start) / gRounds << " ms/change";
+  cout << "  nodes: " << graph.Size() << "  checksum: " << reference << endl;
+  if (checksum != reference)
+    cout << "  (different costs)" << endl;
+}
+
+//***********************************************************************
+//***********************************************************************
+//***********************************************************************
+
+int main(int argc, char **argv)
+{
+    // Benchmark number
+  int test_num = 0;
+  if (argc > 1)
+    test_num = std::atoi(argv[1]);
+
+    // Side of the grid
+  if (argc > 2)
+    gSide = static_cast<unsigned>(std::atoi(argv[2]));
+
+    // Searches per measurement
+  if (argc > 3)
+    gRounds = std::atoi(argv[3]);
+
+  typedef void (*BenchFn)(void);
+  BenchFn Tests[] = {
+                     BenchFreeze, // 1 adjacency lists vs CSR
+                     BenchLoad,   // 2 AddDEdge vs AddEdges vs LoadEdges
+                     BenchMany,   // 3 DijkstraMany on 1-32 threads
+                     BenchPoint,  // 4 full Dijkstra vs bidirectional vs A*
+                     BenchDelta,  // 5 Dijkstra vs delta-stepping
+                     BenchHierarchy, // 6 bidirectional vs contraction hierarchy
+                     BenchQueues, // 7 bucket queue vs binary heap
+                     BenchTraversal, // 8 BFS, DFS, components and topological sort
+                     BenchDynamic, // 9 repairing a shortest path tree vs a full search
+                    };
+
+  int num = sizeof(Tests) / sizeof(*Tests);
+  if (test_num == 0)
+  {
+    for (int i = 0; i < num; i++)
+      Tests[i]();
+  }
+  else if (test_num > 0 && test_num <= num)
+  {
+    Tests[test_num - 1]();
+  }
+
+  return 0;
+}
@@ -10,6 +10,573 @@ This file contains the implementation for Sudoku
 ***************************************************************************/
 
 #include "Sudoku.h"
+#include <mutex>    /* std::mutex */
+#include <map>      /* std::map */
+#include <deque>    /* std::deque */
+#include <thread>   /* std::thread */
+#include <chrono>   /* std::chrono::milliseconds */
+#include <condition_variable> /* std::condition_variable */
+#include <system_error>       /* std::system_error */
+
+/*!
+  The exact cover form of a board, searched with Knuth's Algorithm X on
+  dancing links.
+
+  Each matrix row is one symbol in one cell and covers four columns: the
+  cell, and the symbol in its row, in its column and in its sub-grid. A
+  solution is a set of rows that covers every column once. The nodes are
+  kept in parallel arrays of indices; node 0 is the root and nodes 1 to
+  4 * length^2 are the column headers.
+
+  Building the matrix only depends on the basesize, so it is built once per
+  basesize and copied from there. A search leaves the links as it found them,
+  so the same matrix is used for every board a Sudoku object solves: only the
+  givens are covered before the search and uncovered after it.
+*/
+class Sudoku::DancingLinks
+{
+public:
+  explicit DancingLinks(unsigned basesize);
+  static const DancingLinks &Shared(unsigned basesize);
+  bool Solve(Sudoku &sudoku);
+
+private:
+  void Cover(unsigned column);
+  void Uncover(unsigned column);
+  bool Search(Sudoku &sudoku);
+  bool Select(Sudoku &sudoku, unsigned node);
+  void Deselect(Sudoku &sudoku, unsigned node);
+
+  unsigned m_Length;              //!< Symbols, cells per row
+  std::vector<unsigned> m_Left;   //!< Previous node in the row (headers: previous header)
+  std::vector<unsigned> m_Right;  //!< Next node in the row (headers: next header)
+  std::vector<unsigned> m_Up;     //!< Previous node in the column
+  std::vector<unsigned> m_Down;   //!< Next node in the column
+  std::vector<unsigned> m_Column; //!< The column header of each node
+  std::vector<unsigned> m_Size;   //!< Nodes left in each column, by header
+  std::vector<bool> m_Covered;    //!< Whether each column is covered, by header
+};
+
+/**
+ * @brief Builds the exact cover matrix of a board.
+ * 
+ * @param _basesize The base size of the board.
+ */
+Sudoku::DancingLinks::DancingLinks(unsigned _basesize)
+  : m_Length(_basesize * _basesize)
+{
+  const unsigned cells = m_Length * m_Length;
+  const unsigned columns = 4 * cells;
+  const unsigned nodes = 1 + columns + 4 * cells * m_Length;
+  m_Left.resize(nodes);
+  m_Right.resize(nodes);
+  m_Up.resize(nodes);
+  m_Down.resize(nodes);
+  m_Column.resize(nodes);
+  m_Size.assign(columns + 1, 0);
+  m_Covered.assign(columns + 1, false);
+
+  // The root and the headers form one circular list
+  for (unsigned header = 0; header <= columns; ++header) {
+    m_Left[header] = header ? header - 1 : columns;
+    m_Right[header] = header == columns ? 0 : header + 1;
+    m_Up[header] = m_Down[header] = m_Column[header] = header;
+  }
+
+  // Matrix row cell * length + symbol takes the 4 nodes after its index * 4
+  unsigned node = columns + 1;
+  for (unsigned cell = 0; cell < cells; ++cell) {
+    unsigned row = cell / m_Length, column = cell % m_Length;
+    unsigned box = (row / _basesize) * _basesize + column / _basesize;
+    for (unsigned symbol = 0; symbol < m_Length; ++symbol) {
+      const unsigned headers[4] = {
+        1 + cell,
+        1 + cells + row * m_Length + symbol,
+        1 + 2 * cells + column * m_Length + symbol,
+        1 + 3 * cells + box * m_Length + symbol
+      };
+      for (unsigned k = 0; k < 4; ++k, ++node) {
+        unsigned header = headers[k];
+        m_Left[node] = k ? node - 1 : node + 3;
+        m_Right[node] = k == 3 ? node - 3 : node + 1;
+        m_Column[node] = header;
+        m_Up[node] = m_Up[header];
+        m_Down[node] = header;
+        m_Down[m_Up[header]] = node;
+        m_Up[header] = node;
+        ++m_Size[header];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Gets the matrix of a basesize, building it the first time.
+ * 
+ * @param _basesize The base size of the board.
+ * @return The matrix, never changed, to be copied by each Sudoku object.
+ */
+const Sudoku::DancingLinks &Sudoku::DancingLinks::Shared(unsigned _basesize)
+{
+  static std::mutex lock;
+  static std::map<unsigned, std::unique_ptr<const DancingLinks> > built;
+
+  std::lock_guard<std::mutex> guard(lock);
+  std::unique_ptr<const DancingLinks> &links = built[_basesize];
+  if (!links)
+    links.reset(new DancingLinks(_basesize));
+  return *links;
+}
+
+/**
+ * @brief Solves the board of a Sudoku object.
+ * 
+ * The givens are selected first, without any messages. Givens that clash
+ * leave no exact cover, so such a board has no solution. Cells holding
+ * something other than a symbol of the board are treated as empty.
+ * 
+ * @param _sudoku The object whose board is solved in place.
+ * @return true if a solution was found; false otherwise or on an abort.
+ */
+bool Sudoku::DancingLinks::Solve(Sudoku &_sudoku)
+{
+  const unsigned cells = m_Length * m_Length;
+  std::vector<unsigned> givens;
+  bool clash = false;
+  for (unsigned cell = 0; cell < cells && !clash; ++cell) {
+    char value = _sudoku.m_Board[cell];
+    if (value == EMPTY_CHAR || value < _sudoku.FirstSymbol())
+      continue;
+    unsigned symbol = static_cast<unsigned>(value - _sudoku.FirstSymbol());
+    if (symbol >= m_Length)
+      continue;
+
+    // The first node of the matrix row of this symbol in this cell
+    unsigned first = 1 + 4 * cells + 4 * (cell * m_Length + symbol);
+    for (unsigned k = 0; k < 4; ++k)
+      clash = clash || m_Covered[m_Column[first + k]];
+    if (clash)
+      break;
+    for (unsigned k = 0; k < 4; ++k)
+      Cover(m_Column[first + k]);
+    givens.push_back(first);
+  }
+
+  bool solved = !clash && Search(_sudoku);
+
+  while (!givens.empty()) {
+    unsigned first = givens.back();
+    givens.pop_back();
+    for (unsigned k = 4; k-- > 0; )
+      Uncover(m_Column[first + k]);
+  }
+  return solved;
+}
+
+/**
+ * @brief Takes a column and every row that meets it out of the matrix.
+ * 
+ * @param _column The column header.
+ */
+void Sudoku::DancingLinks::Cover(unsigned _column)
+{
+  m_Covered[_column] = true;
+  m_Right[m_Left[_column]] = m_Right[_column];
+  m_Left[m_Right[_column]] = m_Left[_column];
+  for (unsigned row = m_Down[_column]; row != _column; row = m_Down[row]) {
+    for (unsigned node = m_Right[row]; node != row; node = m_Right[node]) {
+      m_Down[m_Up[node]] = m_Down[node];
+      m_Up[m_Down[node]] = m_Up[node];
+      --m_Size[m_Column[node]];
+    }
+  }
+}
+
+/**
+ * @brief Puts back a column taken out by Cover, in the reverse order.
+ * 
+ * @param _column The column header.
+ */
+void Sudoku::DancingLinks::Uncover(unsigned _column)
+{
+  for (unsigned row = m_Up[_column]; row != _column; row = m_Up[row]) {
+    for (unsigned node = m_Left[row]; node != row; node = m_Left[node]) {
+      ++m_Size[m_Column[node]];
+      m_Down[m_Up[node]] = node;
+      m_Up[m_Down[node]] = node;
+    }
+  }
+  m_Right[m_Left[_column]] = _column;
+  m_Left[m_Right[_column]] = _column;
+  m_Covered[_column] = false;
+}
+
+/**
+ * @brief Algorithm X: covers the column with the fewest rows and tries each
+ *        of its rows in turn.
+ * 
+ * The links are put back on every way out, so the solution is only kept on
+ * the board.
+ * 
+ * @param _sudoku The object whose board and statistics are updated.
+ * @return true if every column was covered; false on a dead end or an abort.
+ */
+bool Sudoku::DancingLinks::Search(Sudoku &_sudoku)
+{
+  if (m_Right[0] == 0)
+    return true;
+
+  unsigned column = m_Right[0];
+  for (unsigned header = m_Right[column]; header != 0 && m_Size[column] > 1; header = m_Right[header])
+    if (m_Size[header] < m_Size[column])
+      column = header;
+  if (m_Size[column] == 0)
+    return false;
+
+  Cover(column);
+  bool solved = false;
+  for (unsigned row = m_Down[column]; row != column && !solved; row = m_Down[row]) {
+    if (!Select(_sudoku, row)) {
+      _sudoku.m_Aborted = true;
+      break;
+    }
+    for (unsigned node = m_Right[row]; node != row; node = m_Right[node])
+      Cover(m_Column[node]);
+
+    solved = Search(_sudoku);
+
+    for (unsigned node = m_Left[row]; node != row; node = m_Left[node])
+      Uncover(m_Column[node]);
+    if (!solved) {
+      Deselect(_sudoku, row);
+      if (_sudoku.m_Aborted)
+        break;
+      ++_sudoku.m_Stats.backtracks;
+    }
+  }
+  Uncover(column);
+  return solved;
+}
+
+/**
+ * @brief Places the symbol of a matrix row on the board.
+ * 
+ * @param _sudoku The object whose board and statistics are updated.
+ * @param _node Any node of the matrix row.
+ * @return true if placed; false if the callback asked to abort.
+ */
+bool Sudoku::DancingLinks::Select(Sudoku &_sudoku, unsigned _node)
+{
+  // Matrix row cell * length + symbol, from the 4 nodes it takes
+  unsigned row = (_node - 1 - 4 * m_Length * m_Length) / 4;
+  unsigned cell = row / m_Length, symbol = row % m_Length;
+  char value = static_cast<char>(_sudoku.FirstSymbol() + symbol);
+
+  if (_sudoku.m_Callback && _sudoku.m_Callback(_sudoku, _sudoku.m_Board, MessageType::MSG_ABORT_CHECK, _sudoku.m_Stats.moves, _sudoku.m_Stats.basesize, cell, value))
+    return false;
+
+  _sudoku.m_Board[cell] = value;
+  ++_sudoku.m_Stats.moves;
+  ++_sudoku.m_Stats.placed;
+  if (_sudoku.m_Callback)
+    _sudoku.m_Callback(_sudoku, _sudoku.m_Board, MessageType::MSG_PLACING, _sudoku.m_Stats.moves, _sudoku.m_Stats.basesize, cell, value);
+  return true;
+}
+
+/**
+ * @brief Takes the symbol of a matrix row back off the board.
+ * 
+ * @param _sudoku The object whose board and statistics are updated.
+ * @param _node Any node of the matrix row.
+ */
+void Sudoku::DancingLinks::Deselect(Sudoku &_sudoku, unsigned _node)
+{
+  unsigned cell = (_node - 1 - 4 * m_Length * m_Length) / 4 / m_Length;
+  char value = _sudoku.m_Board[cell];
+
+  _sudoku.m_Board[cell] = EMPTY_CHAR;
+  --_sudoku.m_Stats.placed;
+  if (_sudoku.m_Callback)
+    _sudoku.m_Callback(_sudoku, _sudoku.m_Board, MessageType::MSG_REMOVING, _sudoku.m_Stats.moves, _sudoku.m_Stats.basesize, cell, value);
+}
+
+
+/*!
+  STRATEGY_BACKTRACK split over several threads.
+
+  A task is a copy of the board with some of the first empty cells filled
+  in. Tasks shallower than the split depth are expanded: each symbol that
+  fits in the next empty cell becomes a new task. Deeper ones are searched
+  with PlaceValue on a Sudoku object of the worker's own. Each worker keeps
+  its tasks in a deque and takes the newest one; a worker that runs out
+  steals the oldest, and so largest, task of another. The first worker to
+  fill the board stops the rest.
+
+  The workers never call the callback. The calling thread sends
+  MSG_ABORT_CHECK with the moves so far every SAMPLE_MS milliseconds and
+  stops the search if asked to, so the callback is never called from two
+  threads at once and never slows the workers down.
+*/
+class Sudoku::ParallelSearch
+{
+public:
+  ParallelSearch(Sudoku &sudoku, unsigned threads);
+  bool Run();
+
+private:
+  //! A board with some of the first empty cells filled in
+  struct Task
+  {
+    std::vector<char> board; //!< The board
+    unsigned next;           //!< Cells before this one are filled
+    unsigned depth;          //!< Cells filled since the givens
+  };
+
+  //! The tasks of one worker: the owner takes from the back, thieves from the front
+  struct Queue
+  {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  static const int SAMPLE_MS = 10;   //!< Time between MSG_ABORT_CHECK messages
+  static const unsigned SPLIT = 32;  //!< Tasks to aim for per thread
+
+  void Work(unsigned worker);
+  bool Take(unsigned worker, Task &task);
+  void Expand(Sudoku &state, const Task &task, unsigned worker);
+  void Found(const char *board);
+
+  Sudoku &m_Sudoku;
+  unsigned m_Threads;
+  unsigned m_SplitDepth;                    //!< Tasks this deep are searched, not expanded
+  std::vector<std::unique_ptr<Queue> > m_Queues;
+  std::atomic<bool> m_Stop;                 //!< Solved or aborted
+  std::atomic<size_t> m_Pending;            //!< Tasks pushed and not yet finished
+  std::atomic<size_t> m_Moves;              //!< Moves of finished tasks
+  std::unique_ptr<std::atomic<size_t>[]> m_Progress; //!< Moves of each worker's current task
+  std::atomic<size_t> m_Backtracks;         //!< Backtracks of finished tasks
+
+  std::mutex m_ResultLock;
+  bool m_Solved;
+  std::vector<char> m_Result;
+
+  std::mutex m_RunningLock;
+  std::condition_variable m_Finished;
+  unsigned m_Running;                       //!< Workers still looking for tasks
+};
+
+const int Sudoku::ParallelSearch::SAMPLE_MS;
+const unsigned Sudoku::ParallelSearch::SPLIT;
+
+/**
+ * @brief Prepares to split the search of a board.
+ * 
+ * The split depth is the least that gives every thread SPLIT tasks if
+ * every symbol fitted; fewer fit, but then each task is also smaller.
+ * 
+ * @param _sudoku The object whose board is solved.
+ * @param _threads The number of threads, at least 2.
+ */
+Sudoku::ParallelSearch::ParallelSearch(Sudoku &_sudoku, unsigned _threads)
+  : m_Sudoku(_sudoku), m_Threads(_threads), m_SplitDepth(0), m_Stop(false),
+    m_Pending(0), m_Moves(0), m_Progress(new std::atomic<size_t>[_threads]), m_Backtracks(0),
+    m_Solved(false), m_Running(0)
+{
+  for (size_t tasks = 1; _sudoku.m_Length > 1 && tasks < static_cast<size_t>(m_Threads) * SPLIT; tasks *= _sudoku.m_Length)
+    ++m_SplitDepth;
+  for (unsigned worker = 0; worker < m_Threads; ++worker) {
+    m_Queues.emplace_back(new Queue);
+    m_Progress[worker] = 0;
+  }
+}
+
+/**
+ * @brief Runs the workers until one fills the board or every task is done.
+ * 
+ * The solution, or the givens if there is none, is left on the board of the
+ * object, and the moves and backtracks of all the workers are added to its
+ * statistics. If no thread can be started, the search runs on the calling
+ * thread.
+ * 
+ * @return true if a solution was found; false otherwise or on an abort.
+ */
+bool Sudoku::ParallelSearch::Run()
+{
+  const unsigned cells = static_cast<unsigned>(m_Sudoku.m_Length * m_Sudoku.m_Length);
+  Task root = {std::vector<char>(m_Sudoku.m_Board, m_Sudoku.m_Board + cells), 0, 0};
+  m_Queues[0]->tasks.push_back(root);
+  m_Pending = 1;
+
+  m_Running = m_Threads;
+  std::vector<std::thread> threads;
+  for (unsigned worker = 0; worker < m_Threads; ++worker) {
+    try {
+      threads.emplace_back(&ParallelSearch::Work, this, worker);
+    }
+    catch (const std::system_error &) {
+      // Go on with the threads there are
+      std::lock_guard<std::mutex> guard(m_RunningLock);
+      m_Running -= m_Threads - worker;
+      break;
+    }
+  }
+
+  if (threads.empty()) {
+    m_Running = 1;
+    Work(0);
+  }
+  else {
+    std::unique_lock<std::mutex> lock(m_RunningLock);
+    while (m_Running) {
+      m_Finished.wait_for(lock, std::chrono::milliseconds(SAMPLE_MS));
+      if (m_Running && m_Sudoku.m_Callback) {
+        lock.unlock();
+        size_t moves = m_Sudoku.m_Stats.moves + m_Moves;
+        for (unsigned worker = 0; worker < m_Threads; ++worker)
+          moves += m_Progress[worker].load(std::memory_order_relaxed);
+        if (m_Sudoku.m_Callback(m_Sudoku, m_Sudoku.m_Board, MessageType::MSG_ABORT_CHECK,
+                                moves, m_Sudoku.m_Stats.basesize, static_cast<unsigned>(-1), 0)) {
+          m_Sudoku.m_Aborted = true;
+          m_Stop = true;
+        }
+        lock.lock();
+      }
+    }
+  }
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  m_Sudoku.m_Stats.moves += m_Moves;
+  m_Sudoku.m_Stats.backtracks += m_Backtracks;
+  if (m_Solved) {
+    for (unsigned cell = 0; cell < cells; ++cell)
+      if (m_Sudoku.m_Board[cell] == EMPTY_CHAR)
+        ++m_Sudoku.m_Stats.placed;
+    std::copy(m_Result.begin(), m_Result.end(), m_Sudoku.m_Board);
+  }
+  return m_Solved;
+}
+
+/**
+ * @brief The loop of one worker thread.
+ * 
+ * @param _worker The index of the worker and of its queue.
+ */
+void Sudoku::ParallelSearch::Work(unsigned _worker)
+{
+  const unsigned length = static_cast<unsigned>(m_Sudoku.m_Length);
+  Sudoku state(m_Sudoku.m_Stats.basesize, m_Sudoku.m_SymbolType);
+  state.m_Stop = &m_Stop;
+  state.m_Progress = &m_Progress[_worker];
+
+  Task task;
+  while (Take(_worker, task)) {
+    std::copy(task.board.begin(), task.board.end(), state.m_Board);
+    state.BuildMasks();
+    state.m_Stats.placed = 0;
+    state.m_Stats.moves = state.m_Stats.backtracks = 0;
+
+    if (task.depth < m_SplitDepth)
+      Expand(state, task, _worker);
+    else if (state.PlaceValue(task.next % length, task.next / length))
+      Found(state.m_Board);
+
+    m_Moves += state.m_Stats.moves;
+    m_Progress[_worker] = 0;
+    m_Backtracks += state.m_Stats.backtracks;
+    --m_Pending;
+  }
+
+  std::lock_guard<std::mutex> guard(m_RunningLock);
+  --m_Running;
+  m_Finished.notify_all();
+}
+
+/**
+ * @brief Gets the next task of a worker, stealing one if it has none.
+ * 
+ * @param _worker The index of the worker.
+ * @param _task Receives the task.
+ * @return true if there is a task; false once the search is over.
+ */
+bool Sudoku::ParallelSearch::Take(unsigned _worker, Task &_task)
+{
+  while (!m_Stop) {
+    for (unsigned k = 0; k < m_Threads; ++k) {
+      Queue &queue = *m_Queues[(_worker + k) % m_Threads];
+      std::lock_guard<std::mutex> guard(queue.lock);
+      if (queue.tasks.empty())
+        continue;
+      if (k == 0) {
+        _task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      }
+      else {
+        _task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      return true;
+    }
+
+    // Every task is done, or another worker is still expanding one
+    if (m_Pending == 0)
+      return false;
+    std::this_thread::yield();
+  }
+  return false;
+}
+
+/**
+ * @brief Makes a task for each symbol that fits in the next empty cell.
+ * 
+ * Every symbol counts as a move, the same as in PlaceValue. The tasks are
+ * pushed so that the owner takes the lowest symbol first.
+ * 
+ * @param _state The worker's object, holding the board of the task.
+ * @param _task The task.
+ * @param _worker The index of the worker.
+ */
+void Sudoku::ParallelSearch::Expand(Sudoku &_state, const Task &_task, unsigned _worker)
+{
+  const unsigned length = static_cast<unsigned>(m_Sudoku.m_Length);
+  unsigned cell = _task.next;
+  while (cell < length * length && _state.m_Board[cell] != EMPTY_CHAR)
+    ++cell;
+  if (cell == length * length) {
+    Found(_state.m_Board);
+    return;
+  }
+
+  Mask candidates = _state.Candidates(cell % length, cell / length);
+  _state.m_Stats.moves += length;
+
+  Queue &queue = *m_Queues[_worker];
+  for (unsigned symbol = length; symbol-- > 0; ) {
+    if (!((candidates >> symbol) & 1))
+      continue;
+    Task child = {_task.board, cell + 1, _task.depth + 1};
+    child.board[cell] = static_cast<char>(_state.FirstSymbol() + symbol);
+    ++m_Pending;
+    std::lock_guard<std::mutex> guard(queue.lock);
+    queue.tasks.push_back(std::move(child));
+  }
+}
+
+/**
+ * @brief Keeps the first solution found and stops the other workers.
+ * 
+ * @param _board The filled board.
+ */
+void Sudoku::ParallelSearch::Found(const char *_board)
+{
+  std::lock_guard<std::mutex> guard(m_ResultLock);
+  if (!m_Solved) {
+    m_Solved = true;
+    m_Result.assign(_board, _board + m_Sudoku.m_Length * m_Sudoku.m_Length);
+  }
+  m_Stop = true;
+}
 
 /**
  * @brief Constructs a Sudoku solver instance.
@@ -19,7 +586,8 @@ This file contains the implementation for Sudoku
  * @param _callback A callback function that is called at certain events during solving.
  */
 Sudoku::Sudoku(int _basesize, SymbolType _stype, SUDOKU_CALLBACK _callback)
-    : m_SymbolType{_stype}, m_Callback{_callback}
+    : m_SymbolType{_stype}, m_Callback{_callback}, m_Strategy{STRATEGY_BACKTRACK}, m_Aborted{false},
+      m_Threads{1}, m_Stop{nullptr}, m_Progress{nullptr}
 {
   m_Length = _basesize * _basesize;
   m_Stats.basesize = _basesize;
@@ -40,9 +608,9 @@ Sudoku::~Sudoku()
  * @param _values Array containing the initial board values.
  * @param _size The size of the values array.
  */
-void Sudoku::SetupBoard(const char *_values, size_t _size)
+void Sudoku::SetupBoard(const char *_values, int _size)
 {
-  for (size_t i = 0; i < _size; ++i)
+  for (int i = 0; i < _size; ++i)
     m_Board[i] = _values[i] == '.' ? EMPTY_CHAR : _values[i];
 }
 
@@ -52,6 +620,11 @@ void Sudoku::SetupBoard(const char *_values, size_t _size)
  * Recursively tries to solve the Sudoku puzzle by placing a value in an empty cell
  * and checking for the validity of this placement. If a valid placement cannot be
  * found, backtracks to previous placements.
+ *
+ * The symbols that fit are read from the row, column and sub-grid masks, so
+ * checking a placement takes one AND. Every symbol still counts as a move,
+ * whether it fits or not. Without a callback nobody sees the symbols that do
+ * not fit, so they are counted and skipped in one step.
  * 
  * @param _column The column index where the value is to be placed.
  * @param _row The row index where the value is to be placed.
@@ -67,63 +640,278 @@ bool Sudoku::PlaceValue(unsigned _column, unsigned _row)
     return true;
   }
 
+  // The next cell, wrapping to the next row at the end of this one
+  unsigned nextColumn = _column == m_Length - 1 ? 0 : _column + 1;
+  unsigned nextRow = _column == m_Length - 1 ? _row + 1 : _row;
+
   // If the current cell is not empty, move to the next cell
-  if (m_Board[linearIndex] != EMPTY_CHAR) {
-    // Check if we're at the end of the row to wrap to the next row
-    if (_column == m_Length - 1) {
-      if (PlaceValue(0, _row + 1)) return true;
-    } else {
-      // Not at the end, simply move to the next column
-      if (PlaceValue(_column + 1, _row)) return true;
-    }
-    // If neither condition is met, it means we cannot proceed and must backtrack
-    return false;
-  }
+  if (m_Board[linearIndex] != EMPTY_CHAR)
+    return PlaceValue(nextColumn, nextRow);
 
-  // Start with the lowest possible value based on the symbol type
-  char currentValue = m_SymbolType == SymbolType::SYM_NUMBER ? '1' : 'A';
+  // The symbols that are not yet in this row, column or sub-grid
+  Mask candidates = Candidates(_column, _row);
+  const unsigned length = static_cast<unsigned>(m_Length);
 
   // Try placing all possible values in the current cell
-  for (size_t i = 0; i < m_Length; ++i) {
+  for (unsigned symbol = 0; symbol < length; ++symbol) {
+    // As a worker of a parallel search: stop once another one is done
+    if (m_Stop) {
+      if (m_Stop->load(std::memory_order_relaxed))
+        return false;
+      m_Progress->store(m_Stats.moves, std::memory_order_relaxed);
+    }
+
+    if (!m_Callback) {
+      // Count the symbols up to the next one that fits as tried
+      Mask left = candidates >> symbol;
+      if (!left) {
+        m_Stats.moves += length - symbol;
+        return false;
+      }
+      unsigned skipped = CountTrailingZeros(left);
+      m_Stats.moves += skipped;
+      symbol += skipped;
+    }
     // Invoke the callback function to determine if we should abort the current attempt
-    if (m_Callback(*this, m_Board, MessageType::MSG_ABORT_CHECK, m_Stats.moves, m_Stats.basesize, linearIndex, currentValue))
+    else if (m_Callback(*this, m_Board, MessageType::MSG_ABORT_CHECK, m_Stats.moves, m_Stats.basesize, linearIndex, static_cast<char>(FirstSymbol() + symbol))) {
+      m_Aborted = true;
       return false;
+    }
+
+    char currentValue = static_cast<char>(FirstSymbol() + symbol);
 
     // Place the current value and update stats
     m_Board[linearIndex] = currentValue;
     ++m_Stats.moves;
     ++m_Stats.placed;
     // Inform the callback about the placement
-    m_Callback(*this, m_Board, MessageType::MSG_PLACING, m_Stats.moves, m_Stats.basesize, linearIndex, currentValue);
+    if (m_Callback)
+      m_Callback(*this, m_Board, MessageType::MSG_PLACING, m_Stats.moves, m_Stats.basesize, linearIndex, currentValue);
 
     // If the current value is valid, proceed to place the next value
-    if (CheckValidity(_column, _row, currentValue)) {
-      // If we're at the end of the row, wrap to the next
-      if (_column == m_Length - 1) {
-        if (PlaceValue(0, _row + 1)) return true;
-      } else {
-        if (PlaceValue(_column + 1, _row)) return true;
-      }
+    if ((candidates >> symbol) & 1) {
+      Mark(_column, _row, symbol);
+      if (PlaceValue(nextColumn, nextRow)) return true;
+      Unmark(_column, _row, symbol);
+
       // If the placement leads to a dead end, backtrack by resetting the cell
       m_Board[linearIndex] = EMPTY_CHAR;
       ++m_Stats.backtracks;
       // Inform the callback about the removal
-      m_Callback(*this, m_Board, MessageType::MSG_REMOVING, m_Stats.moves, m_Stats.basesize, linearIndex, currentValue);
+      if (m_Callback)
+        m_Callback(*this, m_Board, MessageType::MSG_REMOVING, m_Stats.moves, m_Stats.basesize, linearIndex, currentValue);
     }
 
     // If the value did not lead to a solution, reset the cell and decrement placed count
     m_Board[linearIndex] = EMPTY_CHAR;
     --m_Stats.placed;
     // Inform the callback about the removal
-    m_Callback(*this, m_Board, MessageType::MSG_REMOVING, m_Stats.moves, m_Stats.basesize, linearIndex, currentValue);
-    // Move to the next potential value
-    ++currentValue;
+    if (m_Callback)
+      m_Callback(*this, m_Board, MessageType::MSG_REMOVING, m_Stats.moves, m_Stats.basesize, linearIndex, currentValue);
   }
 
   // If no valid placement was found, return false to trigger backtracking
   return false;
 }
 
+/**
+ * @brief Searches for the solution, filling the most constrained cell first.
+ * 
+ * First fills every cell that Propagate can deduce. Then picks the empty cell
+ * with the fewest symbols that fit and tries each of them in turn, undoing
+ * everything that followed from a symbol before trying the next one. Each
+ * symbol that is taken back counts as a backtrack.
+ * 
+ * @return true if the board was filled; false on a dead end or an abort.
+ */
+bool Sudoku::Search()
+{
+  if (!Propagate())
+    return false;
+
+  // The empty cell with the fewest candidates (at least 2 after Propagate)
+  unsigned best = static_cast<unsigned>(-1);
+  unsigned bestCount = static_cast<unsigned>(m_Length) + 1;
+  for (unsigned index = 0; index < m_Length * m_Length && bestCount > 2; ++index) {
+    if (m_Board[index] != EMPTY_CHAR)
+      continue;
+    unsigned count = CountBits(Candidates(index % static_cast<unsigned>(m_Length), index / static_cast<unsigned>(m_Length)));
+    if (count < bestCount) {
+      best = index;
+      bestCount = count;
+    }
+  }
+
+  // Every cell is filled
+  if (best == static_cast<unsigned>(-1))
+    return true;
+
+  Mask candidates = Candidates(best % static_cast<unsigned>(m_Length), best / static_cast<unsigned>(m_Length));
+  size_t mark = m_Trail.size();
+  while (candidates) {
+    unsigned symbol = CountTrailingZeros(candidates);
+    candidates &= candidates - 1;
+
+    if (!Assign(best, symbol))
+      return false;
+    if (Search())
+      return true;
+    if (m_Aborted)
+      return false;
+
+    Undo(mark);
+    ++m_Stats.backtracks;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Fills the cells whose symbol is forced until there are none left.
+ * 
+ * A naked single is an empty cell where only one symbol fits. A hidden single
+ * is a symbol that fits in only one cell of a row, column or sub-grid. An
+ * empty cell where nothing fits, or a symbol with no cell left in a unit, is
+ * a dead end.
+ * 
+ * @return true if no dead end was found; false on a dead end or an abort.
+ */
+bool Sudoku::Propagate()
+{
+  const unsigned length = static_cast<unsigned>(m_Length);
+  const Mask all = m_Length >= 64 ? ~Mask(0) : (Mask(1) << m_Length) - 1;
+
+  for (bool changed = true; changed; ) {
+    changed = false;
+
+    // Naked singles
+    for (unsigned index = 0; index < length * length; ++index) {
+      if (m_Board[index] != EMPTY_CHAR)
+        continue;
+      Mask candidates = Candidates(index % length, index / length);
+      if (!candidates)
+        return false;
+      if (!(candidates & (candidates - 1))) {
+        if (!Assign(index, CountTrailingZeros(candidates)))
+          return false;
+        changed = true;
+      }
+    }
+
+    // Hidden singles: rows, then columns, then sub-grids
+    for (unsigned unit = 0; unit < 3 * length; ++unit) {
+      Mask used = unit < length ? m_RowUsed[unit]
+                : unit < 2 * length ? m_ColumnUsed[unit - length] : m_BoxUsed[unit - 2 * length];
+      Mask once = 0, twice = 0;
+      for (unsigned k = 0; k < length; ++k) {
+        unsigned index = UnitCell(unit, k);
+        if (m_Board[index] != EMPTY_CHAR)
+          continue;
+        Mask candidates = Candidates(index % length, index / length);
+        twice |= once & candidates;
+        once |= candidates;
+      }
+
+      // A symbol that is not in the unit and has no cell left
+      if (all & ~used & ~once)
+        return false;
+
+      for (Mask hidden = once & ~twice; hidden; hidden &= hidden - 1) {
+        unsigned symbol = CountTrailingZeros(hidden);
+        unsigned k = 0;
+        while (k < length) {
+          unsigned index = UnitCell(unit, k);
+          if (m_Board[index] == EMPTY_CHAR && ((Candidates(index % length, index / length) >> symbol) & 1))
+            break;
+          ++k;
+        }
+        // Another single of this unit took its only cell
+        if (k == length)
+          return false;
+        if (!Assign(UnitCell(unit, k), symbol))
+          return false;
+        changed = true;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Places a symbol in an empty cell for Search.
+ * 
+ * Sends the same messages as PlaceValue and remembers the cell so that Undo
+ * can take it back.
+ * 
+ * @param _index The linear index of the cell.
+ * @param _symbol The symbol, 0 for '1' or 'A'. It must fit in the cell.
+ * @return true if placed; false if the callback asked to abort.
+ */
+bool Sudoku::Assign(unsigned _index, unsigned _symbol)
+{
+  const unsigned length = static_cast<unsigned>(m_Length);
+  char value = static_cast<char>(FirstSymbol() + _symbol);
+
+  if (m_Callback && m_Callback(*this, m_Board, MessageType::MSG_ABORT_CHECK, m_Stats.moves, m_Stats.basesize, _index, value)) {
+    m_Aborted = true;
+    return false;
+  }
+
+  m_Board[_index] = value;
+  Mark(_index % length, _index / length, _symbol);
+  m_Trail.push_back(_index);
+  ++m_Stats.moves;
+  ++m_Stats.placed;
+  if (m_Callback)
+    m_Callback(*this, m_Board, MessageType::MSG_PLACING, m_Stats.moves, m_Stats.basesize, _index, value);
+  return true;
+}
+
+/**
+ * @brief Takes back the cells that Search filled since a point, newest first.
+ * 
+ * @param _mark The size the trail had at that point.
+ */
+void Sudoku::Undo(size_t _mark)
+{
+  const unsigned length = static_cast<unsigned>(m_Length);
+  while (m_Trail.size() > _mark) {
+    unsigned index = m_Trail.back();
+    m_Trail.pop_back();
+
+    char value = m_Board[index];
+    Unmark(index % length, index / length, static_cast<unsigned>(value - FirstSymbol()));
+    m_Board[index] = EMPTY_CHAR;
+    --m_Stats.placed;
+    if (m_Callback)
+      m_Callback(*this, m_Board, MessageType::MSG_REMOVING, m_Stats.moves, m_Stats.basesize, index, value);
+  }
+}
+
+/**
+ * @brief Finds a cell of a row, column or sub-grid.
+ * 
+ * @param _unit 0 to length - 1 for the rows, then the columns, then the
+ *        sub-grids counted row by row from the top left.
+ * @param _k Which cell of the unit, 0 to length - 1.
+ * @return The linear index of the cell.
+ */
+unsigned Sudoku::UnitCell(unsigned _unit, unsigned _k) const
+{
+  const unsigned length = static_cast<unsigned>(m_Length);
+  const unsigned base = static_cast<unsigned>(m_Stats.basesize);
+  if (_unit < length)
+    return _unit * length + _k;
+  if (_unit < 2 * length)
+    return _k * length + (_unit - length);
+
+  unsigned box = _unit - 2 * length;
+  unsigned row = (box / base) * base + _k / base;
+  unsigned column = (box % base) * base + _k % base;
+  return row * length + column;
+}
+
 /**
  * @brief Solves the Sudoku puzzle.
  * 
@@ -131,71 +919,306 @@ bool Sudoku::PlaceValue(unsigned _column, unsigned _row)
  * handles the callbacks for starting, successful completion, and failure.
  */
 void Sudoku::Solve()
+{
+  Run();
+}
+
+/**
+ * @brief Solves the board with the chosen strategy, sending the messages.
+ * 
+ * @return true if a solution was found; false otherwise or on an abort.
+ */
+bool Sudoku::Run()
 {
   unsigned x = 0;
   unsigned y = 0;
 
-  m_Callback(*this, m_Board, MessageType::MSG_STARTING, m_Stats.moves, m_Stats.basesize, -1, 0);
+  BuildMasks();
+  m_Aborted = false;
 
-  if (PlaceValue(x, y))
-    m_Callback(*this, m_Board, MessageType::MSG_FINISHED_OK, m_Stats.moves, m_Stats.basesize, -1, 0);
+  if (m_Callback)
+    m_Callback(*this, m_Board, MessageType::MSG_STARTING, m_Stats.moves, m_Stats.basesize, static_cast<unsigned>(-1), 0);
+
+  bool solved;
+  if (m_Strategy == STRATEGY_PROPAGATE) {
+    m_Trail.clear();
+    solved = Search();
+    if (!solved)
+      Undo(0); // Leave only the givens, the same as PlaceValue
+  }
+  else if (m_Strategy == STRATEGY_DANCING_LINKS) {
+    if (!m_Links)
+      m_Links.reset(new DancingLinks(DancingLinks::Shared(static_cast<unsigned>(m_Stats.basesize))));
+    solved = m_Links->Solve(*this);
+  }
+  else if (m_Threads > 1)
+    solved = ParallelSearch(*this, m_Threads).Run();
   else
-    m_Callback(*this, m_Board, MessageType::MSG_FINISHED_FAIL, m_Stats.moves, m_Stats.basesize, -1, 0);
+    solved = PlaceValue(x, y);
+  if (m_Callback)
+    m_Callback(*this, m_Board, solved ? MessageType::MSG_FINISHED_OK : MessageType::MSG_FINISHED_FAIL,
+               m_Stats.moves, m_Stats.basesize, static_cast<unsigned>(-1), 0);
+  return solved;
 }
 
 /**
- * @brief Checks the validity of a value placed at a given row and column.
+ * @brief Solves many boards of the size and symbols of this object.
+ * 
+ * Each thread (see SetThreads) solves its share of the boards with one
+ * Sudoku object of its own, so the board, the masks and the exact cover
+ * matrix are made once per thread instead of once per board. The chosen
+ * strategy is used, on one thread per board. The board and statistics of
+ * this object are left alone.
  * 
- * Verifies that the placement of the value does not conflict with the existing
- * values in the same row, column, or subgrid.
+ * No callbacks are sent unless _sample is set: then every _sample-th board
+ * is solved with the callback, sending its messages as Solve would, one
+ * board at a time. If the callback asks such a board to abort, no more
+ * boards are started.
  * 
- * @param _column The column index of the cell to check.
- * @param _row The row index of the cell to check.
- * @param _value The value to check.
- * @return true if the value does not cause any conflicts; false otherwise.
+ * @param _puzzles The boards, one after the other, length * length symbols
+ *        each, with '.' or EMPTY_CHAR for the empty cells.
+ * @param _count The number of boards.
+ * @param _out Receives the boards in the same layout: the solution, or the
+ *        givens (with EMPTY_CHAR for the empty cells) if there is none. It
+ *        may be the same array as _puzzles.
+ * @param _sample 0 for no callbacks, N to send the messages of every Nth board.
+ * @return The number of boards solved, the moves and backtracks over all of
+ *         them, and the time taken and boards per second.
  */
-bool Sudoku::CheckValidity(unsigned _column, unsigned _row, char _value)
+Sudoku::BatchStats Sudoku::SolveBatch(const char *_puzzles, size_t _count, char *_out, size_t _sample)
 {
-  // Calculate the linear index from column and row for one-dimensional board access
-  // Add explicit casting to avoid warning for conversion from 'size_t' to 'unsigned int'
-  unsigned linearIndex = static_cast<unsigned>(_column + static_cast<unsigned long>(m_Length) * _row);
+  const size_t cells = m_Length * m_Length;
+  const size_t CHUNK = 64; // Boards a thread takes at a time
+  std::atomic<size_t> next(0);
+  std::atomic<bool> stop(false);
+  std::mutex lock; // Guards the totals and the sampled boards
+  BatchStats totals;
+  totals.puzzles = _count;
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  auto work = [&]() {
+    Sudoku worker(m_Stats.basesize, m_SymbolType);
+    worker.m_Strategy = m_Strategy;
+    size_t solved = 0, moves = 0, backtracks = 0;
+    for (size_t first; (first = next.fetch_add(CHUNK)) < _count; ) {
+      for (size_t i = first; i < first + CHUNK && i < _count; ++i) {
+        worker.SetupBoard(_puzzles + i * cells, static_cast<int>(cells));
+        if (!stop.load(std::memory_order_relaxed)) {
+          // Every board counts from zero, as it would in an object of its own
+          worker.m_Stats.placed = 0;
+          worker.m_Stats.moves = 0;
+          worker.m_Stats.backtracks = 0;
+          if (_sample && m_Callback && i % _sample == 0) {
+            std::lock_guard<std::mutex> guard(lock);
+            worker.m_Callback = m_Callback;
+            solved += worker.Run();
+            worker.m_Callback = 0;
+            if (worker.m_Aborted)
+              stop = true;
+          }
+          else
+            solved += worker.Run();
+          moves += worker.m_Stats.moves;
+          backtracks += worker.m_Stats.backtracks;
+        }
+        std::copy(worker.m_Board, worker.m_Board + cells, _out + i * cells);
+      }
+    }
 
-  // Check for conflicts in the current row and column
-  for (size_t i = 0; i < m_Length; ++i) {
-    // Add explicit casting to avoid warning for conversion from 'size_t' to 'unsigned int'
-    unsigned rowIndex = static_cast<unsigned>(i + static_cast<unsigned long>(m_Length) * _row); // Linear index for the row check
-    unsigned colIndex = static_cast<unsigned>(_column + static_cast<unsigned long>(m_Length) * i); // Linear index for the column check
+    std::lock_guard<std::mutex> guard(lock);
+    totals.solved += solved;
+    totals.moves += moves;
+    totals.backtracks += backtracks;
+  };
 
-    // If the value exists elsewhere in the same row or column, return false
-    if ((linearIndex != rowIndex) && (_value == m_Board[rowIndex])) return false;
-    if ((linearIndex != colIndex) && (_value == m_Board[colIndex])) return false;
+  // The calling thread works too
+  std::vector<std::thread> threads;
+  for (unsigned thread = 1; thread < m_Threads; ++thread) {
+    try {
+      threads.emplace_back(work);
+    }
+    catch (const std::system_error &) {
+      break; // Go on with the threads there are
+    }
   }
+  work();
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
 
-  // Determine the maximum width and height of the subgrid containing the cell
-  // The calculation is safe from overflow as _column and _row will not exceed the Sudoku grid size
-  unsigned subgridMaxColumn = static_cast<unsigned>(_column / m_Stats.basesize) * m_Stats.basesize + m_Stats.basesize - 1;
-  unsigned subgridMaxRow = static_cast<unsigned>(_row / m_Stats.basesize) * m_Stats.basesize + m_Stats.basesize - 1;
+  totals.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  totals.rate = totals.seconds > 0 ? static_cast<double>(_count) / totals.seconds : 0;
+  return totals;
+}
 
-  // Determine the starting point for the subgrid
-  unsigned subgridMinColumn = subgridMaxColumn - m_Stats.basesize + 1;
-  unsigned subgridMinRow = subgridMaxRow - m_Stats.basesize + 1;
+/**
+ * @brief Chooses how the next Solve searches.
+ * 
+ * STRATEGY_BACKTRACK fills the cells row by row and tries every symbol in
+ * order, the way the moves in data/output were counted. STRATEGY_PROPAGATE
+ * fills forced cells first and then guesses in the cell with the fewest
+ * candidates; it makes far fewer moves on hard boards. STRATEGY_DANCING_LINKS
+ * searches the exact cover form of the board, which covers the same singles
+ * as part of picking the tightest column. All of them send the same kinds of
+ * messages and keep the same statistics.
+ * 
+ * @param _strategy The strategy to use.
+ */
+void Sudoku::SetStrategy(Strategy _strategy)
+{
+  m_Strategy = _strategy;
+}
+
+/**
+ * @brief Splits STRATEGY_BACKTRACK over several threads.
+ * 
+ * The first few empty cells are filled in every way that fits, and the
+ * boards that result are shared out to the threads, which steal from each
+ * other when they run out. The first thread to fill the board stops the
+ * others, so if there are several solutions the one found can vary, and
+ * the moves and backtracks, summed over the threads, are not those of a
+ * search on one thread. MSG_PLACING and MSG_REMOVING are not sent; the
+ * calling thread sends MSG_ABORT_CHECK every few milliseconds instead.
+ * 
+ * @param _threads The number of threads; 0 and 1 search on the calling thread.
+ */
+void Sudoku::SetThreads(unsigned _threads)
+{
+  m_Threads = _threads;
+}
 
-  // Check the subgrid for conflicts
-  for (unsigned i = subgridMinRow; i <= subgridMaxRow; ++i) {
-    for (unsigned j = subgridMinColumn; j <= subgridMaxColumn; ++j) {
-      // Add explicit casting to avoid warning for conversion from 'size_t' to 'unsigned int'
-      unsigned currentIndex = static_cast<unsigned>(j + static_cast<unsigned long>(m_Length) * i); // Linear index for the subgrid check
-      
-      // Skip the check for the cell itself and cells in the same row or column
-      if (i == _row || j == _column) continue;
+/**
+ * @brief Fills the row, column and sub-grid masks from the board.
+ * 
+ * Cells holding something other than one of the symbols of the board are
+ * treated as empty for the masks, the same as before: no symbol can clash
+ * with them.
+ */
+void Sudoku::BuildMasks()
+{
+  m_RowUsed.assign(m_Length, 0);
+  m_ColumnUsed.assign(m_Length, 0);
+  m_BoxUsed.assign(m_Length, 0);
 
-      // If the value exists elsewhere in the subgrid, return false
-      if (m_Board[currentIndex] == _value) return false;
+  for (unsigned row = 0; row < m_Length; ++row) {
+    for (unsigned column = 0; column < m_Length; ++column) {
+      char value = m_Board[column + m_Length * row];
+      if (value == EMPTY_CHAR || value < FirstSymbol())
+        continue;
+      unsigned symbol = static_cast<unsigned>(value - FirstSymbol());
+      if (symbol < m_Length)
+        Mark(column, row, symbol);
     }
   }
-  
-  // If no conflicts are found, the placement is valid
-  return true;
+}
+
+/**
+ * @brief Finds the sub-grid of a cell.
+ * 
+ * @param _column The column index of the cell.
+ * @param _row The row index of the cell.
+ * @return The index of the sub-grid, counted row by row from the top left.
+ */
+unsigned Sudoku::Box(unsigned _column, unsigned _row) const
+{
+  unsigned base = static_cast<unsigned>(m_Stats.basesize);
+  return (_row / base) * base + _column / base;
+}
+
+/**
+ * @brief Finds the symbols that can go in a cell.
+ * 
+ * @param _column The column index of the cell.
+ * @param _row The row index of the cell.
+ * @return A mask with a bit set for each symbol that is not yet in the row,
+ *         column or sub-grid of the cell.
+ */
+Sudoku::Mask Sudoku::Candidates(unsigned _column, unsigned _row) const
+{
+  Mask all = m_Length >= 64 ? ~Mask(0) : (Mask(1) << m_Length) - 1;
+  return all & ~(m_RowUsed[_row] | m_ColumnUsed[_column] | m_BoxUsed[Box(_column, _row)]);
+}
+
+/**
+ * @brief Records a symbol as used in the row, column and sub-grid of a cell.
+ * 
+ * @param _column The column index of the cell.
+ * @param _row The row index of the cell.
+ * @param _symbol The symbol, 0 for '1' or 'A'.
+ */
+void Sudoku::Mark(unsigned _column, unsigned _row, unsigned _symbol)
+{
+  Mask bit = Mask(1) << _symbol;
+  m_RowUsed[_row] |= bit;
+  m_ColumnUsed[_column] |= bit;
+  m_BoxUsed[Box(_column, _row)] |= bit;
+}
+
+/**
+ * @brief Records a symbol as free again in the row, column and sub-grid of a cell.
+ * 
+ * Only a symbol that fitted is ever taken back, so no other cell in the row,
+ * column or sub-grid holds it.
+ * 
+ * @param _column The column index of the cell.
+ * @param _row The row index of the cell.
+ * @param _symbol The symbol, 0 for '1' or 'A'.
+ */
+void Sudoku::Unmark(unsigned _column, unsigned _row, unsigned _symbol)
+{
+  Mask bit = ~(Mask(1) << _symbol);
+  m_RowUsed[_row] &= bit;
+  m_ColumnUsed[_column] &= bit;
+  m_BoxUsed[Box(_column, _row)] &= bit;
+}
+
+/**
+ * @brief Gets the lowest symbol of the board.
+ * 
+ * @return '1' for numbers, 'A' for letters.
+ */
+char Sudoku::FirstSymbol() const
+{
+  return m_SymbolType == SymbolType::SYM_NUMBER ? '1' : 'A';
+}
+
+/**
+ * @brief Counts the zero bits below the lowest set bit.
+ * 
+ * @param _mask The mask, not 0.
+ * @return The index of the lowest set bit.
+ */
+unsigned Sudoku::CountTrailingZeros(Mask _mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  // A single instruction
+  return static_cast<unsigned>(__builtin_ctzll(_mask));
+#else
+  unsigned count = 0;
+  while (!(_mask & 1))
+  {
+    ++count;
+    _mask >>= 1;
+  }
+  return count;
+#endif
+}
+
+/**
+ * @brief Counts the set bits.
+ * 
+ * @param _mask The mask.
+ * @return The number of set bits.
+ */
+unsigned Sudoku::CountBits(Mask _mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(_mask));
+#else
+  unsigned count = 0;
+  for (; _mask; _mask &= _mask - 1)
+    ++count;
+  return count;
+#endif
 }
 
 /**
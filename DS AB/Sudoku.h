@@ -3,6 +3,9 @@
 #define SUDOKUH
 //---------------------------------------------------------------------------
 #include <cstddef> /* size_t */
+#include <vector>  /* std::vector */
+#include <memory>  /* std::unique_ptr */
+#include <atomic>  /* std::atomic */
 
 //! The Sudoku class
 class Sudoku
@@ -26,6 +29,14 @@ public:
     SYM_LETTER
   };
 
+  //! How Solve searches for the solution
+  enum Strategy
+  {
+    STRATEGY_BACKTRACK, //!< row by row, every symbol in order (the default)
+    STRATEGY_PROPAGATE, //!< fewest candidates first, filling naked and hidden singles
+    STRATEGY_DANCING_LINKS //!< exact cover with Knuth's Algorithm X on dancing links
+  };
+
   //! Represents an empty cell (the driver will use a . instead)
   const static char EMPTY_CHAR = ' ';
 
@@ -56,6 +67,20 @@ public:
     SudokuStats() : basesize(0), placed(0), moves(0), backtracks(0) {}
   };
 
+  //! Totals of a SolveBatch call
+  struct BatchStats
+  {
+    size_t puzzles;    //!< the number of boards in the batch
+    size_t solved;     //!< the number of boards solved
+    size_t moves;      //!< total number of values tried over all the boards
+    size_t backtracks; //!< total number of backtracks over all the boards
+    double seconds;    //!< time taken
+    double rate;       //!< boards per second
+
+    //!< Default constructor
+    BatchStats() : puzzles(0), solved(0), moves(0), backtracks(0), seconds(0), rate(0) {}
+  };
+
   // Constructor
   Sudoku(int basesize, SymbolType stype = SYM_NUMBER, SUDOKU_CALLBACK callback = 0);
 
@@ -68,19 +93,58 @@ public:
   // Once the board is setup, this will start the search for the solution
   void Solve();
 
+  // Chooses how the next Solve searches
+  void SetStrategy(Strategy strategy);
+
+  // Splits STRATEGY_BACKTRACK over several threads (1, the default, searches on the calling thread)
+  void SetThreads(unsigned threads);
+
+  // Solves count boards of this size from puzzles into out, spread over the threads
+  BatchStats SolveBatch(const char *puzzles, size_t count, char *out, size_t sample = 0);
+
   // For debugging with the driver
   const char *GetBoard() const;
   SudokuStats GetStats() const;
 
 private:
+  class DancingLinks;
+  class ParallelSearch;
+
+  //! One bit per symbol, bit 0 is '1' or 'A' (so at most 64 symbols, basesize 8)
+  typedef unsigned long long Mask;
+
   size_t m_Length;
   char *m_Board;
   SymbolType m_SymbolType;
   SudokuStats m_Stats;
   SUDOKU_CALLBACK m_Callback;
+  Strategy m_Strategy;
+
+  std::vector<Mask> m_RowUsed;    //!< Symbols already in each row
+  std::vector<Mask> m_ColumnUsed; //!< Symbols already in each column
+  std::vector<Mask> m_BoxUsed;    //!< Symbols already in each sub-grid
+  std::vector<unsigned> m_Trail;  //!< Cells filled by Search, in order
+  bool m_Aborted;                 //!< The callback asked Search to stop
+  std::unique_ptr<DancingLinks> m_Links; //!< Exact cover matrix, made on first use
+  unsigned m_Threads;                    //!< Threads for STRATEGY_BACKTRACK
+  const std::atomic<bool> *m_Stop;       //!< Set when another thread found the solution
+  std::atomic<size_t> *m_Progress;       //!< Moves so far, for the thread sending callbacks
 
+  bool Run();
   bool PlaceValue(unsigned x, unsigned y);
-  bool CheckValidity(unsigned x, unsigned y, char val);
+  bool Search();
+  bool Propagate();
+  bool Assign(unsigned index, unsigned symbol);
+  void Undo(size_t mark);
+  unsigned UnitCell(unsigned unit, unsigned k) const;
+  void BuildMasks();
+  unsigned Box(unsigned x, unsigned y) const;
+  Mask Candidates(unsigned x, unsigned y) const;
+  void Mark(unsigned x, unsigned y, unsigned symbol);
+  void Unmark(unsigned x, unsigned y, unsigned symbol);
+  char FirstSymbol() const;
+  static unsigned CountTrailingZeros(Mask mask);
+  static unsigned CountBits(Mask mask);
 };
 
 #endif // SUDOKUH
@@ -0,0 +1,411 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "Sudoku.h"
+
+size_t gMoveLimit = 100000000; // Searches give up after this many moves
+unsigned gSeed = 1;            // Seed for the generated boards
+
+using std::cout;
+using std::endl;
+
+//*********************************************************************
+// Helpers
+//*********************************************************************
+
+  // A board to solve, with the size and symbols it uses
+struct Puzzle
+{
+  std::string name;
+  int basesize;
+  Sudoku::SymbolType symbols;
+  std::string board;
+};
+
+  // Hard 9x9 boards that are well known. The last one is built so that
+  // filling the cells in order needs tens of millions of moves.
+const char *HARD9[] = {
+  "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3..", // AI Escargot
+  "4.....8.5.3..........7......2.....6.....8.4......1.......6.3.7.5..2.....1.4......",
+  ".......39.....1..5..3.5.8....8.9...6.7...2..1..4.......9.8..5..2....6..4..7.....", // Golden Nugget
+  "1.......2.9.4...5...6...7...5.9.3.......7.......85..4.7.....6...3...9.8...2.....1", // Easter Monster
+  "..............3.85..1.2.......5.7.....4...1...9.......5......73..2.1........4...9",
+};
+
+size_t gLimitMoves = 0; // Move count at which the current search stops
+
+bool Watch(const Sudoku &, const char *, Sudoku::MessageType message, size_t move,
+           unsigned, unsigned, char)
+{
+  return message == Sudoku::MSG_ABORT_CHECK && move >= gLimitMoves;
+}
+
+  // Whether a board has no empty cell left
+bool Filled(const char *board, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    if (board[i] == Sudoku::EMPTY_CHAR)
+      return false;
+  return true;
+}
+
+  // Reads the first board of a file in data/input
+bool ReadBoard(const char *file, int basesize, Sudoku::SymbolType symbols, std::vector<Puzzle> &puzzles)
+{
+  std::string path = std::string("data/input/") + file;
+  std::ifstream in(path.c_str());
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    Puzzle puzzle = {file, basesize, symbols, line};
+    puzzles.push_back(puzzle);
+    return true;
+  }
+  cout << "(" << path << " not found)" << endl;
+  return false;
+}
+
+  // A random full board: the solution of the empty board with its symbols,
+  // bands, stacks, rows and columns shuffled, which keeps it valid
+std::string MakeSolution(int basesize, char first, std::mt19937 &rng)
+{
+  unsigned base = static_cast<unsigned>(basesize), length = base * base;
+  std::string empty(length * length, '.');
+  Sudoku sudoku(basesize, first == '1' ? Sudoku::SYM_NUMBER : Sudoku::SYM_LETTER);
+  sudoku.SetStrategy(Sudoku::STRATEGY_PROPAGATE);
+  sudoku.SetupBoard(empty.c_str(), static_cast<int>(empty.size()));
+  sudoku.Solve();
+  std::string solution(sudoku.GetBoard(), length * length);
+
+  std::vector<unsigned> symbol(length), rows(length), columns(length), order(base);
+  for (unsigned i = 0; i < length; i++)
+    symbol[i] = i;
+  std::shuffle(symbol.begin(), symbol.end(), rng);
+  for (unsigned i = 0; i < base; i++)
+    order[i] = i;
+  for (int pass = 0; pass < 2; pass++)
+  {
+    std::vector<unsigned> &lines = pass ? columns : rows;
+    std::shuffle(order.begin(), order.end(), rng);
+    for (unsigned band = 0; band < base; band++)
+    {
+      std::vector<unsigned> inner(order);
+      std::shuffle(inner.begin(), inner.end(), rng);
+      for (unsigned i = 0; i < base; i++)
+        lines[band * base + i] = order[band] * base + inner[i];
+    }
+  }
+
+  std::string board(length * length, ' ');
+  for (unsigned row = 0; row < length; row++)
+    for (unsigned column = 0; column < length; column++)
+    {
+      char value = solution[rows[row] * length + columns[column]];
+      board[row * length + column] = static_cast<char>(first + symbol[static_cast<unsigned>(value - first)]);
+    }
+  return board;
+}
+
+  // Random boards with a fraction of the cells given
+void MakeBoards(int basesize, double givens, int count, std::vector<Puzzle> &puzzles)
+{
+  std::mt19937 rng(gSeed + static_cast<unsigned>(basesize));
+  Sudoku::SymbolType symbols = basesize > 3 ? Sudoku::SYM_LETTER : Sudoku::SYM_NUMBER;
+  std::bernoulli_distribution keep(givens);
+  for (int i = 0; i < count; i++)
+  {
+    std::string board = MakeSolution(basesize, basesize > 3 ? 'A' : '1', rng);
+    for (size_t cell = 0; cell < board.size(); cell++)
+      if (!keep(rng))
+        board[cell] = '.';
+    char name[32];
+    std::snprintf(name, sizeof(name), "random %d-%d", basesize, i + 1);
+    Puzzle puzzle = {name, basesize, symbols, board};
+    puzzles.push_back(puzzle);
+  }
+}
+
+  // Solves every board with one strategy and prints the totals
+void TimeStrategy(const char *name, Sudoku::Strategy strategy, const std::vector<Puzzle> &puzzles)
+{
+  size_t moves = 0, backtracks = 0;
+  int solved = 0, gaveUp = 0;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < puzzles.size(); i++)
+  {
+    gLimitMoves = gMoveLimit;
+    Sudoku sudoku(puzzles[i].basesize, puzzles[i].symbols, Watch);
+    sudoku.SetStrategy(strategy);
+    sudoku.SetupBoard(puzzles[i].board.c_str(), static_cast<int>(puzzles[i].board.size()));
+    sudoku.Solve();
+
+    Sudoku::SudokuStats stats = sudoku.GetStats();
+    moves += stats.moves;
+    backtracks += stats.backtracks;
+    if (Filled(sudoku.GetBoard(), puzzles[i].board.size()))
+      solved++;
+    else if (stats.moves >= gMoveLimit)
+      gaveUp++;
+  }
+  std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+  double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+
+  cout << std::left << std::setw(12) << name << std::right;
+  cout << " time: " << std::setw(10) << std::fixed << std::setprecision(2) << ms << " ms";
+  cout << "  moves: " << std::setw(10) << moves << "  backtracks: " << std::setw(9) << backtracks;
+  cout << "  solved: " << solved << "/" << puzzles.size();
+  if (gaveUp)
+    cout << " (" << gaveUp << " gave up)";
+  cout << endl;
+}
+
+  // Milliseconds since a starting point
+double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+//*********************************************************************
+// Benchmarks
+//*********************************************************************
+
+  // Row by row backtracking against fewest candidates first with singles
+void BenchStrategies(void)
+{
+  const char *test = "BenchStrategies";
+  std::cout << "\n====================== " << test << " ======================\n";
+  cout << "move limit: " << gMoveLimit << endl;
+
+  std::vector<std::vector<Puzzle> > sets(3);
+  for (size_t i = 0; i < sizeof(HARD9) / sizeof(*HARD9); i++)
+  {
+    Puzzle puzzle = {"hard 9x9", 3, Sudoku::SYM_NUMBER, HARD9[i]};
+    sets[0].push_back(puzzle);
+  }
+  ReadBoard("board3-fifth.txt", 3, Sudoku::SYM_NUMBER, sets[0]);
+  ReadBoard("board4-2.txt", 4, Sudoku::SYM_LETTER, sets[1]);
+  MakeBoards(4, 0.35, 5, sets[1]);
+  ReadBoard("board5-1.txt", 5, Sudoku::SYM_LETTER, sets[2]);
+  MakeBoards(5, 0.55, 5, sets[2]);
+
+  const char *names[] = {"9x9", "16x16", "25x25"};
+  for (size_t s = 0; s < sets.size(); s++)
+  {
+    cout << names[s] << ", boards: " << sets[s].size() << endl;
+    TimeStrategy("backtrack", Sudoku::STRATEGY_BACKTRACK, sets[s]);
+    TimeStrategy("propagate", Sudoku::STRATEGY_PROPAGATE, sets[s]);
+    TimeStrategy("dancing", Sudoku::STRATEGY_DANCING_LINKS, sets[s]);
+  }
+}
+
+  // Building the exact cover matrix against reusing it for many boards
+void BenchDancingLinks(void)
+{
+  const char *test = "BenchDancingLinks";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  for (int basesize = 3; basesize <= 5; basesize++)
+  {
+    std::vector<Puzzle> puzzles;
+    MakeBoards(basesize, basesize == 5 ? 0.6 : 0.45, 100, puzzles);
+    Sudoku::SymbolType symbols = puzzles[0].symbols;
+    int size = static_cast<int>(puzzles[0].board.size());
+    double count = static_cast<double>(puzzles.size());
+    gLimitMoves = gMoveLimit;
+
+      // The first object of a basesize builds the matrix, later ones copy it
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+      Sudoku sudoku(basesize, symbols, Watch);
+      sudoku.SetStrategy(Sudoku::STRATEGY_DANCING_LINKS);
+      sudoku.SetupBoard(puzzles[0].board.c_str(), size);
+      sudoku.Solve();
+    }
+    double first = ElapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    size_t moves = 0;
+    for (size_t i = 0; i < puzzles.size(); i++)
+    {
+      Sudoku sudoku(basesize, symbols, Watch);
+      sudoku.SetStrategy(Sudoku::STRATEGY_DANCING_LINKS);
+      sudoku.SetupBoard(puzzles[i].board.c_str(), size);
+      sudoku.Solve();
+      moves += sudoku.GetStats().moves;
+    }
+    double each = ElapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    Sudoku reused(basesize, symbols, Watch);
+    reused.SetStrategy(Sudoku::STRATEGY_DANCING_LINKS);
+    for (size_t i = 0; i < puzzles.size(); i++)
+    {
+      reused.SetupBoard(puzzles[i].board.c_str(), size);
+      reused.Solve();
+    }
+    double again = ElapsedMs(start);
+
+    cout << basesize * basesize << "x" << basesize * basesize << ", boards: " << puzzles.size();
+    cout << std::fixed << std::setprecision(3) << "  first board: " << first << " ms";
+    cout << "  new object: " << each / count << " ms/board";
+    cout << "  same object: " << again / count << " ms/board";
+    cout << "  moves: " << moves << "/" << reused.GetStats().moves << endl;
+  }
+}
+
+  // Row by row backtracking on one thread against the same search split
+  // over a work-stealing pool
+void BenchParallel(void)
+{
+  const char *test = "BenchParallel";
+  std::cout << "\n====================== " << test << " ======================\n";
+  cout << "move limit: " << gMoveLimit << ", hardware threads: " << std::thread::hardware_concurrency() << endl;
+
+  std::vector<Puzzle> puzzles;
+  for (size_t i = 0; i < sizeof(HARD9) / sizeof(*HARD9); i++)
+  {
+    Puzzle puzzle = {"hard 9x9", 3, Sudoku::SYM_NUMBER, HARD9[i]};
+    puzzles.push_back(puzzle);
+  }
+  ReadBoard("board3-fifth.txt", 3, Sudoku::SYM_NUMBER, puzzles);
+  ReadBoard("board4-2.txt", 4, Sudoku::SYM_LETTER, puzzles);
+
+  for (size_t i = 0; i < puzzles.size(); i++)
+  {
+    cout << puzzles[i].name << " " << i + 1 << endl;
+    for (unsigned threads = 1; threads <= 8; threads *= 2)
+    {
+      gLimitMoves = gMoveLimit;
+      Sudoku sudoku(puzzles[i].basesize, puzzles[i].symbols, Watch);
+      sudoku.SetThreads(threads);
+      sudoku.SetupBoard(puzzles[i].board.c_str(), static_cast<int>(puzzles[i].board.size()));
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      sudoku.Solve();
+      double ms = ElapsedMs(start);
+
+      Sudoku::SudokuStats stats = sudoku.GetStats();
+      cout << "  " << threads << " thr  time: " << std::setw(10) << std::fixed << std::setprecision(2) << ms << " ms";
+      cout << "  moves: " << std::setw(10) << stats.moves << "  backtracks: " << std::setw(9) << stats.backtracks;
+      cout << (Filled(sudoku.GetBoard(), puzzles[i].board.size()) ? "  solved" : "  gave up") << endl;
+    }
+  }
+}
+
+size_t gMessages = 0; // Messages the sampled boards of a batch have sent
+
+bool Count(const Sudoku &, const char *, Sudoku::MessageType, size_t, unsigned, unsigned, char)
+{
+  gMessages++;
+  return false;
+}
+
+  // One object per board against SolveBatch with and without sampled
+  // callbacks, on 1-4 threads
+void BenchBatch(void)
+{
+  const char *test = "BenchBatch";
+  std::cout << "\n====================== " << test << " ======================\n";
+  cout << "hardware threads: " << std::thread::hardware_concurrency() << endl;
+
+  std::vector<Puzzle> puzzles;
+  MakeBoards(3, 0.45, 20000, puzzles);
+  const size_t cells = puzzles[0].board.size();
+  std::string batch;
+  for (size_t i = 0; i < puzzles.size(); i++)
+    batch += puzzles[i].board;
+  std::vector<char> out(batch.size());
+  double count = static_cast<double>(puzzles.size());
+  cout << "9x9, boards: " << puzzles.size() << endl;
+
+  Sudoku::Strategy strategies[] = {Sudoku::STRATEGY_PROPAGATE, Sudoku::STRATEGY_DANCING_LINKS};
+  const char *names[] = {"propagate", "dancing"};
+  for (size_t s = 0; s < sizeof(strategies) / sizeof(*strategies); s++)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t solved = 0;
+    for (size_t i = 0; i < puzzles.size(); i++)
+    {
+      Sudoku sudoku(3, Sudoku::SYM_NUMBER);
+      sudoku.SetStrategy(strategies[s]);
+      sudoku.SetupBoard(puzzles[i].board.c_str(), static_cast<int>(cells));
+      sudoku.Solve();
+      solved += Filled(sudoku.GetBoard(), cells);
+    }
+    double ms = ElapsedMs(start);
+    cout << std::left << std::setw(10) << names[s] << std::right << " one object each    ";
+    cout << std::setw(10) << std::fixed << std::setprecision(0) << count * 1000 / ms << " boards/s";
+    cout << "  solved: " << solved << endl;
+
+    for (unsigned threads = 1; threads <= 4; threads *= 2)
+      for (size_t sample = 0; sample <= 100; sample += 100)
+      {
+        gMessages = 0;
+        Sudoku sudoku(3, Sudoku::SYM_NUMBER, sample ? Count : 0);
+        sudoku.SetStrategy(strategies[s]);
+        sudoku.SetThreads(threads);
+        Sudoku::BatchStats stats = sudoku.SolveBatch(batch.c_str(), puzzles.size(), &out[0], sample);
+
+        cout << std::left << std::setw(10) << names[s] << std::right << " batch " << threads << " thr ";
+        cout << (sample ? "sampled" : "quiet  ");
+        cout << std::setw(10) << std::fixed << std::setprecision(0) << stats.rate << " boards/s";
+        cout << "  solved: " << stats.solved << "  moves: " << stats.moves;
+        if (sample)
+          cout << "  messages: " << gMessages;
+        cout << endl;
+      }
+  }
+}
+
+//***********************************************************************
+//***********************************************************************
+//***********************************************************************
+
+int main(int argc, char **argv)
+{
+    // Benchmark number
+  int test_num = 0;
+  if (argc > 1)
+    test_num = std::atoi(argv[1]);
+
+    // Moves before a search gives up
+  if (argc > 2)
+    gMoveLimit = static_cast<size_t>(std::atoll(argv[2]));
+
+    // Seed for the generated boards
+  if (argc > 3)
+    gSeed = static_cast<unsigned>(std::atoi(argv[3]));
+
+  typedef void (*BenchFn)(void);
+  BenchFn Tests[] = {
+                     BenchStrategies,   // 1 backtracking vs propagation vs dancing links
+                     BenchDancingLinks, // 2 exact cover matrix built vs copied vs reused
+                     BenchParallel,     // 3 backtracking on 1-8 threads
+                     BenchBatch,        // 4 one object per board vs SolveBatch
+                    };
+
+  int num = sizeof(Tests) / sizeof(*Tests);
+  if (test_num == 0)
+  {
+    for (int i = 0; i < num; i++)
+      Tests[i]();
+  }
+  else if (test_num > 0 && test_num <= num)
+  {
+    Tests[test_num - 1]();
+  }
+
+  return 0;
+}